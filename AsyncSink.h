@@ -0,0 +1,137 @@
+#ifndef ASYNC_SINK_H
+#define ASYNC_SINK_H
+
+#include "DataSink.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Single-producer, single-consumer ring of fixed-size records (a
+// generation plus `width` values). Push and Pop never lock: the producer
+// only advances head and the consumer only advances tail.
+class RecordRing {
+private:
+    size_t width;
+    size_t capacity; // Power of two.
+    std::vector<uint64_t> generations;
+    std::vector<double> values;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+
+public:
+    RecordRing(size_t record_width, size_t min_capacity) : width(record_width), capacity(1) {
+        while (capacity < min_capacity) capacity *= 2;
+        generations.resize(capacity);
+        values.resize(capacity * width);
+    }
+
+    bool TryPush(uint64_t generation, const std::vector<double>& record) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == capacity) return false;
+        size_t slot = h & (capacity - 1);
+        generations[slot] = generation;
+        std::copy(record.begin(), record.begin() + width, values.begin() + slot * width);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(uint64_t& generation, std::vector<double>& record) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        size_t slot = t & (capacity - 1);
+        generation = generations[slot];
+        record.assign(values.begin() + slot * width, values.begin() + (slot + 1) * width);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Moves formatting and I/O of another sink onto a writer thread. Write
+// copies the row into a RecordRing and returns; the writer thread pops rows
+// and passes them to the wrapped sink. The simulation only waits if the
+// ring fills up. The ring gets as many rows as fit in ring_bytes, rounded
+// down to a power of two, between 2 and max_ring_rows, so a sink with one
+// column per patch does not allocate thousands of full rows.
+class AsyncSink : public DataSink {
+private:
+    static constexpr size_t max_ring_rows = 4096;
+    std::shared_ptr<DataSink> inner;
+    size_t ring_bytes;
+    std::unique_ptr<RecordRing> ring;
+    std::thread writer;
+    std::atomic<bool> done{false};
+    std::atomic<bool> flush_requested{false};
+
+    void Drain() {
+        uint64_t generation;
+        std::vector<double> record;
+        while (true) {
+            if (ring->TryPop(generation, record)) {
+                inner->Write(generation, record);
+                continue;
+            }
+            // Rows pushed before done or a flush request are visible once
+            // the flag is, so drain again before acting on it.
+            if (done.load(std::memory_order_acquire)) {
+                while (ring->TryPop(generation, record)) inner->Write(generation, record);
+                break;
+            }
+            if (flush_requested.load(std::memory_order_acquire)) {
+                while (ring->TryPop(generation, record)) inner->Write(generation, record);
+                inner->Flush();
+                flush_requested.store(false, std::memory_order_release);
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        inner->Flush();
+    }
+
+public:
+    static constexpr size_t default_ring_bytes = size_t(4) << 20;
+
+    explicit AsyncSink(std::shared_ptr<DataSink> wrapped, size_t ring_budget = default_ring_bytes)
+        : inner(std::move(wrapped)), ring_bytes(ring_budget) {}
+
+    // Rows a ring of width-column records gets from a ring_bytes budget.
+    static size_t RingRows(size_t width, size_t ring_bytes) {
+        size_t row_bytes = sizeof(uint64_t) + width * sizeof(double);
+        size_t fit = std::min(max_ring_rows, ring_bytes / row_bytes);
+        size_t rows = 2;
+        while (rows * 2 <= fit) rows *= 2;
+        return rows;
+    }
+
+    AsyncSink(const AsyncSink&) = delete;
+    AsyncSink& operator=(const AsyncSink&) = delete;
+
+    ~AsyncSink() override {
+        if (!writer.joinable()) return;
+        done.store(true, std::memory_order_release);
+        writer.join();
+    }
+
+    void Begin(const std::vector<DataColumn>& columns) override {
+        inner->Begin(columns);
+        ring = std::make_unique<RecordRing>(columns.size(), RingRows(columns.size(), ring_bytes));
+        writer = std::thread([this] { Drain(); });
+    }
+
+    void Write(uint64_t generation, const std::vector<double>& values) override {
+        while (!ring->TryPush(generation, values)) std::this_thread::yield();
+    }
+
+    // Returns once every row written so far has reached the wrapped sink
+    // and it has been flushed.
+    void Flush() override {
+        if (!writer.joinable()) return;
+        flush_requested.store(true, std::memory_order_release);
+        while (flush_requested.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+};
+
+#endif
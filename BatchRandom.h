@@ -0,0 +1,102 @@
+#ifndef BATCH_RANDOM_H
+#define BATCH_RANDOM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+// Bulk random numbers for the sequential step. Eight independent
+// xoshiro256+ generators (lanes) are advanced together by plain loops over
+// their state arrays, which compilers turn into AVX2/AVX-512 code, and each
+// refill produces a whole buffer of uniforms or normals at once. Draws are
+// then served from the buffers. Provides the subset of the emp::Random
+// interface used by World (GetDouble, P, GetUInt, GetRandNormal), with the
+// same distributions.
+class BatchRandom {
+private:
+    static constexpr size_t lanes = 8;
+    static constexpr size_t buffer_size = 512; // A multiple of 2 * lanes.
+
+    uint64_t state[4][lanes];
+    double uniforms[buffer_size];
+    double normals[buffer_size];
+    size_t next_uniform = buffer_size;
+    size_t next_normal = buffer_size;
+
+    static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    static uint64_t SplitMix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+public:
+    explicit BatchRandom(uint64_t seed = 1) { Seed(seed); }
+
+    // Restarts every lane from seed and discards buffered values.
+    void Seed(uint64_t seed) {
+        uint64_t x = seed;
+        for (size_t l = 0; l < lanes; ++l) {
+            for (int w = 0; w < 4; ++w) state[w][l] = SplitMix64(x);
+        }
+        next_uniform = buffer_size;
+        next_normal = buffer_size;
+    }
+
+    // Fills out[0, count) with uniform doubles in [0, 1) with 53 random
+    // bits; count must be a multiple of the lane count.
+    void FillUniforms(double* out, size_t count) {
+        for (size_t base = 0; base < count; base += lanes) {
+            for (size_t l = 0; l < lanes; ++l) {
+                uint64_t result = state[0][l] + state[3][l];
+                uint64_t t = state[1][l] << 17;
+                state[2][l] ^= state[0][l];
+                state[3][l] ^= state[1][l];
+                state[1][l] ^= state[2][l];
+                state[0][l] ^= state[3][l];
+                state[2][l] ^= t;
+                state[3][l] = Rotl(state[3][l], 45);
+                out[base + l] = static_cast<double>(static_cast<int64_t>(result >> 11)) * (1.0 / 9007199254740992.0);
+            }
+        }
+    }
+
+    // Fills out[0, count) with standard normals by the Box-Muller
+    // transform, two per pair of uniforms; count must be a multiple of
+    // twice the lane count.
+    void FillNormals(double* out, size_t count) {
+        size_t half = count / 2;
+        FillUniforms(out, count);
+        for (size_t k = 0; k < half; ++k) {
+            double radius = std::sqrt(-2.0 * std::log(1.0 - out[k])); // (0, 1], keeps log finite.
+            double angle = 6.283185307179586 * out[half + k];
+            out[k] = radius * std::cos(angle);
+            out[half + k] = radius * std::sin(angle);
+        }
+    }
+
+    double GetDouble() {
+        if (next_uniform == buffer_size) {
+            FillUniforms(uniforms, buffer_size);
+            next_uniform = 0;
+        }
+        return uniforms[next_uniform++];
+    }
+
+    bool P(double probability) { return GetDouble() < probability; }
+
+    // Uniform integer in [0, max).
+    uint32_t GetUInt(uint32_t max) { return static_cast<uint32_t>(GetDouble() * max); }
+
+    double GetRandNormal(double mean = 0.0, double sd = 1.0) {
+        if (next_normal == buffer_size) {
+            FillNormals(normals, buffer_size);
+            next_normal = 0;
+        }
+        return mean + sd * normals[next_normal++];
+    }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "ResourceField.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CHECKPOINT_USE_MMAP 1
+#endif
+
+// World checkpoint file (.ckpt), little-endian. A fixed header is followed
+// by 8-byte aligned sections, in this order:
+//   patch resource  float[patch_count]
+//   patch capacity, danger  float[patch_count] each, only with the environment on
+//   species         uint8[organism_count]
+//   birth zone      int8[organism_count]
+//   captures        uint8[organism_count], only with catches not yet bred from
+//   alpha, tau, move rate  float64[organism_count] each
+//   patch           uint64[organism_count]
+//   std_random      mt19937 state as text, std_random_bytes long
+// Organisms are stored in the store's dense order.
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t patch_count;
+    uint64_t organism_count;
+    uint64_t seed;
+    uint64_t generation;
+    double mutation_rate;
+    double mutation_sd;
+    double predator_death_rate;
+    uint32_t reserved_seed; // Zero; step generators restart from seed and generation.
+    uint8_t offspring_placement;
+    uint8_t indexed_prey_movement;
+    uint8_t batched_random;
+    uint8_t skip_sampling;
+    uint64_t std_random_bytes;
+    uint8_t environment_enabled;
+    uint8_t predation_enabled;
+    uint8_t pending_captures;
+    uint8_t reserved;
+    EnvironmentParams environment;
+    double capture_probability;
+    double conversion;
+
+    static constexpr uint32_t current_version = 3;
+    static constexpr char file_magic[8] = {'P', 'P', 'C', 'K', 'P', 'T', '\0', '\0'};
+};
+static_assert(sizeof(CheckpointHeader) == 128, "CheckpointHeader layout must not change within a version");
+
+// Byte offsets of every section for a given header.
+struct CheckpointLayout {
+    size_t resource, capacity, danger, species, birth_zone, captures, alpha, tau, move_rate, patch, std_random, total;
+
+    static size_t Align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+
+    explicit CheckpointLayout(const CheckpointHeader& header) {
+        size_t n = header.organism_count;
+        resource = Align8(sizeof(CheckpointHeader));
+        size_t field_bytes = header.environment_enabled ? header.patch_count * sizeof(float) : 0;
+        capacity = Align8(resource + header.patch_count * sizeof(float));
+        danger = Align8(capacity + field_bytes);
+        species = Align8(danger + field_bytes);
+        birth_zone = Align8(species + n);
+        captures = Align8(birth_zone + n);
+        alpha = Align8(captures + (header.pending_captures ? n : 0));
+        tau = alpha + n * sizeof(double);
+        move_rate = tau + n * sizeof(double);
+        patch = move_rate + n * sizeof(double);
+        std_random = patch + n * sizeof(uint64_t);
+        total = std_random + header.std_random_bytes;
+    }
+};
+
+// Read-only view of a checkpoint file, memory-mapped where the platform
+// supports it (read into memory otherwise). One CheckpointFile can restore
+// any number of worlds, so forking many runs maps the file only once.
+class CheckpointFile {
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    std::vector<uint8_t> buffer;
+    bool mapped = false;
+    bool valid = false;
+    uint32_t version = 0;
+
+    void Validate() {
+        if (size < sizeof(CheckpointHeader::magic) + sizeof(CheckpointHeader::version)) return;
+        if (std::memcmp(data, CheckpointHeader::file_magic, 8) != 0) return;
+        std::memcpy(&version, data + offsetof(CheckpointHeader, version), sizeof(version));
+        if (version != CheckpointHeader::current_version || size < sizeof(CheckpointHeader)) return;
+        const CheckpointHeader& h = Header();
+        if (h.header_size != sizeof(CheckpointHeader)) return;
+        // Bound the counts before computing offsets, so a crafted header
+        // cannot wrap the layout arithmetic: every patch and every byte of
+        // random state takes space in the file, and a patch holds at most
+        // one organism.
+        if (h.patch_count > size || h.organism_count > h.patch_count || h.std_random_bytes > size) return;
+        valid = CheckpointLayout(h).total <= size;
+    }
+
+public:
+    explicit CheckpointFile(const std::string& path) {
+#ifdef CHECKPOINT_USE_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                data = static_cast<const uint8_t*>(view);
+                size = static_cast<size_t>(info.st_size);
+                mapped = true;
+            }
+        }
+        close(fd);
+#else
+        std::ifstream file(path, std::ios::binary);
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+#endif
+        Validate();
+    }
+
+    CheckpointFile(const CheckpointFile&) = delete;
+    CheckpointFile& operator=(const CheckpointFile&) = delete;
+
+    ~CheckpointFile() {
+#ifdef CHECKPOINT_USE_MMAP
+        if (mapped) munmap(const_cast<uint8_t*>(data), size);
+#endif
+    }
+
+    bool IsValid() const { return valid; }
+    // Format version the file was written with, or 0 if it is not a
+    // checkpoint. Only CheckpointHeader::current_version can be loaded.
+    uint32_t Version() const { return version; }
+    const CheckpointHeader& Header() const { return *reinterpret_cast<const CheckpointHeader*>(data); }
+    CheckpointLayout Layout() const { return CheckpointLayout(Header()); }
+
+    template <typename T>
+    const T* Section(size_t offset) const { return reinterpret_cast<const T*>(data + offset); }
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef COLUMNAR_FILE_H
+#define COLUMNAR_FILE_H
+
+#include "DataSink.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Binary columnar stats file (.ppcol), little-endian:
+//
+//   header: "PPCOL\0\0\0", uint32 version, uint32 column count, then per
+//           column: uint8 type (0 = float64, 1 = int32 count),
+//           uint16 name length, name bytes
+//   blocks: uint32 row count n, uint64 generation[n], then each column's
+//           n values as float64 or int32
+//
+// Rows are grouped into blocks of up to rows_per_block, stored column by
+// column, so a reader can pull one column without parsing the others and
+// counts take 4 bytes instead of their decimal text.
+class BinaryColumnSink : public DataSink {
+private:
+    std::ofstream file;
+    std::vector<DataColumn> columns;
+    size_t rows_per_block;
+    std::vector<uint64_t> block_generations;
+    std::vector<std::vector<double>> block_values; // One vector per column.
+
+    template <typename T>
+    void Put(const T& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    void WriteBlock() {
+        if (block_generations.empty()) return;
+        Put(static_cast<uint32_t>(block_generations.size()));
+        file.write(reinterpret_cast<const char*>(block_generations.data()),
+                   block_generations.size() * sizeof(uint64_t));
+        for (size_t c = 0; c < columns.size(); ++c) {
+            if (columns[c].is_count) {
+                for (double v : block_values[c]) Put(static_cast<int32_t>(v));
+            } else {
+                file.write(reinterpret_cast<const char*>(block_values[c].data()),
+                           block_values[c].size() * sizeof(double));
+            }
+            block_values[c].clear();
+        }
+        block_generations.clear();
+    }
+
+public:
+    static constexpr uint32_t version = 1;
+
+    explicit BinaryColumnSink(const std::string& path, size_t block_rows = 1024)
+        : file(path, std::ios::binary), rows_per_block(block_rows) {}
+
+    ~BinaryColumnSink() override { WriteBlock(); }
+
+    void Begin(const std::vector<DataColumn>& cols) override {
+        columns = cols;
+        block_values.assign(columns.size(), {});
+        file.write("PPCOL\0\0\0", 8);
+        Put(version);
+        Put(static_cast<uint32_t>(columns.size()));
+        for (const DataColumn& column : columns) {
+            Put(static_cast<uint8_t>(column.is_count ? 1 : 0));
+            Put(static_cast<uint16_t>(column.name.size()));
+            file.write(column.name.data(), column.name.size());
+        }
+    }
+
+    void Write(uint64_t generation, const std::vector<double>& values) override {
+        block_generations.push_back(generation);
+        for (size_t c = 0; c < columns.size(); ++c) block_values[c].push_back(values[c]);
+        if (block_generations.size() >= rows_per_block) WriteBlock();
+    }
+
+    // Writes the partial block, so the file is complete up to this row.
+    void Flush() override {
+        WriteBlock();
+        file.flush();
+    }
+};
+
+// Reads a .ppcol file block by block.
+class BinaryColumnReader {
+private:
+    std::ifstream file;
+    std::vector<DataColumn> columns;
+    bool valid = false;
+
+    template <typename T>
+    bool Get(T& value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+public:
+    explicit BinaryColumnReader(const std::string& path) : file(path, std::ios::binary) {
+        char magic[8];
+        uint32_t file_version = 0, count = 0;
+        if (!file.read(magic, 8) || std::memcmp(magic, "PPCOL\0\0\0", 8) != 0) return;
+        if (!Get(file_version) || file_version != BinaryColumnSink::version || !Get(count)) return;
+        for (uint32_t c = 0; c < count; ++c) {
+            uint8_t type;
+            uint16_t length;
+            if (!Get(type) || !Get(length)) return;
+            std::string name(length, '\0');
+            if (!file.read(&name[0], length)) return;
+            columns.push_back({name, type == 1});
+        }
+        valid = true;
+    }
+
+    bool IsValid() const { return valid; }
+    const std::vector<DataColumn>& Columns() const { return columns; }
+
+    // Reads the next block into generations and values[column][row].
+    // Returns false at the end of the file.
+    bool NextBlock(std::vector<uint64_t>& generations, std::vector<std::vector<double>>& values) {
+        uint32_t rows;
+        if (!valid || !Get(rows)) return false;
+        generations.resize(rows);
+        if (!file.read(reinterpret_cast<char*>(generations.data()), rows * sizeof(uint64_t))) return false;
+        values.assign(columns.size(), std::vector<double>(rows));
+        for (size_t c = 0; c < columns.size(); ++c) {
+            if (columns[c].is_count) {
+                std::vector<int32_t> counts(rows);
+                if (!file.read(reinterpret_cast<char*>(counts.data()), rows * sizeof(int32_t))) return false;
+                for (uint32_t r = 0; r < rows; ++r) values[c][r] = counts[r];
+            } else if (!file.read(reinterpret_cast<char*>(values[c].data()), rows * sizeof(double))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Writes every remaining row of a valid reader's file to sink, starting
+// with Begin on its columns.
+inline void ExportColumns(BinaryColumnReader& reader, DataSink& sink) {
+    sink.Begin(reader.Columns());
+    std::vector<uint64_t> generations;
+    std::vector<std::vector<double>> values;
+    std::vector<double> row(reader.Columns().size());
+    while (reader.NextBlock(generations, values)) {
+        for (size_t r = 0; r < generations.size(); ++r) {
+            for (size_t c = 0; c < row.size(); ++c) row[c] = values[c][r];
+            sink.Write(generations[r], row);
+        }
+    }
+    sink.Flush();
+}
+
+#endif
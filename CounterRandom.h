@@ -0,0 +1,102 @@
+#ifndef COUNTER_RANDOM_H
+#define COUNTER_RANDOM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+// Counter-based random stream built on Philox4x32-10. A stream is fully
+// determined by its key (seed, generation) and counter (phase, stream id),
+// so any thread can recreate the exact draws for a given organism without
+// sharing state. Provides the subset of the emp::Random interface used by
+// World (GetDouble, P, GetUInt, GetRandNormal).
+class CounterRandom {
+private:
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t block[4];
+    int block_pos = 4;
+    bool has_spare_normal = false;
+    double spare_normal = 0.0;
+
+    static void MulHiLo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) {
+        uint64_t product = static_cast<uint64_t>(a) * b;
+        hi = static_cast<uint32_t>(product >> 32);
+        lo = static_cast<uint32_t>(product);
+    }
+
+    // SplitMix64 finalizer, a bijection on 64-bit words.
+    static uint64_t Mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    void Refill() {
+        uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            uint32_t hi0, lo0, hi1, lo1;
+            MulHiLo(0xD2511F53u, c[0], hi0, lo0);
+            MulHiLo(0xCD9E8D57u, c[2], hi1, lo1);
+            c[0] = hi1 ^ c[1] ^ k0;
+            c[1] = lo1;
+            c[2] = hi0 ^ c[3] ^ k1;
+            c[3] = lo0;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        for (int i = 0; i < 4; ++i) block[i] = c[i];
+        block_pos = 0;
+        counter[0]++; // Draw index within the stream.
+    }
+
+public:
+    // 64-bit key of (seed, generation). Hashed rather than XORed, so no
+    // simple change to seed and generation together maps onto another
+    // pair's key. For one seed, every generation still gets a distinct key.
+    static uint64_t Key(uint64_t seed, uint64_t generation) { return Mix(Mix(seed) + generation); }
+
+    CounterRandom(uint64_t seed, uint64_t generation, uint32_t phase, uint64_t stream_id) {
+        uint64_t mixed = Key(seed, generation);
+        key[0] = static_cast<uint32_t>(mixed);
+        key[1] = static_cast<uint32_t>(mixed >> 32);
+        counter[0] = 0;
+        counter[1] = static_cast<uint32_t>(stream_id);
+        counter[2] = static_cast<uint32_t>(stream_id >> 32);
+        counter[3] = phase;
+    }
+
+    uint32_t GetUInt32() {
+        if (block_pos == 4) Refill();
+        return block[block_pos++];
+    }
+
+    // Uniform double in [0, 1) with 53 random bits.
+    double GetDouble() {
+        uint64_t bits = (static_cast<uint64_t>(GetUInt32()) << 32) | GetUInt32();
+        return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    bool P(double probability) { return GetDouble() < probability; }
+
+    // Uniform integer in [0, max).
+    uint32_t GetUInt(uint32_t max) { return static_cast<uint32_t>(GetDouble() * max); }
+
+    // Normal variate by the Box-Muller transform.
+    double GetRandNormal(double mean = 0.0, double sd = 1.0) {
+        if (has_spare_normal) {
+            has_spare_normal = false;
+            return mean + sd * spare_normal;
+        }
+        double u1 = 1.0 - GetDouble(); // (0, 1], keeps log finite.
+        double u2 = GetDouble();
+        double radius = std::sqrt(-2.0 * std::log(u1));
+        double angle = 6.283185307179586 * u2;
+        spare_normal = radius * std::sin(angle);
+        has_spare_normal = true;
+        return mean + sd * radius * std::cos(angle);
+    }
+};
+
+#endif
@@ -0,0 +1,276 @@
+#ifndef DATA_COLLECTOR_H
+#define DATA_COLLECTOR_H
+
+#include "World.h"
+#include "DataSink.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+// Computes one row of values from the current world state. Observers are
+// only sampled at the generations they are due, so expensive ones
+// (histograms, snapshots) cost nothing in between.
+class Observer {
+public:
+    virtual ~Observer() = default;
+    virtual std::vector<DataColumn> Columns() const = 0;
+    virtual void Sample(const World& world, std::vector<double>& values) = 0;
+
+protected:
+    static constexpr CensusGroup all_groups[3] = {CensusGroup::Prey1, CensusGroup::Prey2, CensusGroup::Predator};
+
+    static const char* GroupName(CensusGroup group) {
+        if (group == CensusGroup::Prey1) return "Prey1";
+        if (group == CensusGroup::Prey2) return "Prey2";
+        return "Predator";
+    }
+
+    static const char* ZoneName(int zone) {
+        if (zone == 0) return "Low";
+        if (zone == 1) return "Med";
+        return "High";
+    }
+};
+
+// Mean alpha and tau of every group, from the census in O(1).
+class TraitMeansObserver : public Observer {
+public:
+    std::vector<DataColumn> Columns() const override {
+        std::vector<DataColumn> columns;
+        for (CensusGroup group : all_groups) {
+            columns.push_back({std::string("AvgAlpha") + GroupName(group)});
+            columns.push_back({std::string("AvgTau") + GroupName(group)});
+        }
+        return columns;
+    }
+
+    void Sample(const World& world, std::vector<double>& values) override {
+        const PopulationCensus& census = world.GetCensus();
+        for (CensusGroup group : all_groups) {
+            values.push_back(census.MeanAlpha(group));
+            values.push_back(census.MeanTau(group));
+        }
+    }
+};
+
+// Count of every group in every resource zone, from the census in O(1).
+class ZoneCountsObserver : public Observer {
+public:
+    std::vector<DataColumn> Columns() const override {
+        std::vector<DataColumn> columns;
+        for (CensusGroup group : all_groups) {
+            for (int zone = 0; zone < 3; ++zone) {
+                columns.push_back({std::string(GroupName(group)) + ZoneName(zone), true});
+            }
+        }
+        return columns;
+    }
+
+    void Sample(const World& world, std::vector<double>& values) override {
+        const PopulationCensus& census = world.GetCensus();
+        for (CensusGroup group : all_groups) {
+            for (int zone = 0; zone < 3; ++zone) values.push_back(census.Count(group, zone));
+        }
+    }
+};
+
+// The columns of native.cpp's original evolution_data CSV: prey trait
+// means, then prey and predator counts per zone.
+class PopulationStatsObserver : public Observer {
+public:
+    std::vector<DataColumn> Columns() const override {
+        return {{"AvgAlphaPrey1"}, {"AvgTauPrey1"}, {"AvgAlphaPrey2"}, {"AvgTauPrey2"},
+                {"Prey1Low", true}, {"Prey1Med", true}, {"Prey1High", true},
+                {"Prey2Low", true}, {"Prey2Med", true}, {"Prey2High", true},
+                {"PredatorLow", true}, {"PredatorMed", true}, {"PredatorHigh", true}};
+    }
+
+    void Sample(const World& world, std::vector<double>& values) override {
+        const PopulationCensus& census = world.GetCensus();
+        values.push_back(census.MeanAlpha(CensusGroup::Prey1));
+        values.push_back(census.MeanTau(CensusGroup::Prey1));
+        values.push_back(census.MeanAlpha(CensusGroup::Prey2));
+        values.push_back(census.MeanTau(CensusGroup::Prey2));
+        for (CensusGroup group : all_groups) {
+            for (int zone = 0; zone < 3; ++zone) values.push_back(census.Count(group, zone));
+        }
+    }
+};
+
+// Histogram of alpha or tau over one group, with equal-width bins on
+// [0, 1]. Scans that group's organisms each time it is sampled.
+class TraitHistogramObserver : public Observer {
+public:
+    enum class Trait { Alpha, Tau };
+
+private:
+    Trait trait;
+    CensusGroup group;
+    int bins;
+
+public:
+    TraitHistogramObserver(Trait histogram_trait, CensusGroup histogram_group, int num_bins = 10)
+        : trait(histogram_trait), group(histogram_group), bins(std::max(1, num_bins)) {}
+
+    std::vector<DataColumn> Columns() const override {
+        std::vector<DataColumn> columns;
+        for (int b = 0; b < bins; ++b) {
+            std::ostringstream name;
+            name << (trait == Trait::Alpha ? "Alpha" : "Tau") << GroupName(group)
+                 << "_" << std::fixed << std::setprecision(2) << static_cast<double>(b) / bins;
+            columns.push_back({name.str(), true});
+        }
+        return columns;
+    }
+
+    void Sample(const World& world, std::vector<double>& values) override {
+        const OrganismStore& organisms = world.GetOrganisms();
+        size_t begin = group == CensusGroup::Predator ? organisms.PreyEnd() : 0;
+        size_t end = group == CensusGroup::Predator ? organisms.Size() : organisms.PreyEnd();
+        std::vector<double> counts(bins, 0.0);
+        for (size_t d = begin; d < end; ++d) {
+            if (PopulationCensus::GroupOf(organisms.IsPrey(d), organisms.GetTau(d)) != group) continue;
+            double value = trait == Trait::Alpha ? organisms.GetAlpha(d) : organisms.GetTau(d);
+            int b = std::clamp(static_cast<int>(value * bins), 0, bins - 1);
+            counts[b] += 1.0;
+        }
+        values.insert(values.end(), counts.begin(), counts.end());
+    }
+};
+
+// Occupant of every patch: 0 empty, 1 Prey1, 2 Prey2, 3 Predator. One
+// column per patch in row-major order, whatever the world's patch order,
+// so keep its interval long on large worlds.
+class SpatialSnapshotObserver : public Observer {
+private:
+    size_t num_patches;
+
+public:
+    explicit SpatialSnapshotObserver(size_t patch_count) : num_patches(patch_count) {}
+
+    std::vector<DataColumn> Columns() const override {
+        std::vector<DataColumn> columns;
+        for (size_t p = 0; p < num_patches; ++p) columns.push_back({"Patch" + std::to_string(p), true});
+        return columns;
+    }
+
+    void Sample(const World& world, std::vector<double>& values) override {
+        size_t first = values.size();
+        values.resize(first + num_patches, 0.0);
+        const OrganismStore& organisms = world.GetOrganisms();
+        for (size_t d = 0; d < organisms.Size(); ++d) {
+            CensusGroup group = PopulationCensus::GroupOf(organisms.IsPrey(d), organisms.GetTau(d));
+            values[first + world.RowMajorPatchIndex(organisms.GetPatch(d))] = 1.0 + static_cast<int>(group);
+        }
+    }
+};
+
+// Mean resource and danger levels and the number of patches in each zone,
+// for worlds with the dynamic environment (World::EnableEnvironment).
+// Scans every patch each time it is sampled.
+class EnvironmentObserver : public Observer {
+public:
+    std::vector<DataColumn> Columns() const override {
+        return {{"MeanResource"}, {"MeanDanger"}, {"LowPatches", true}, {"MedPatches", true}, {"HighPatches", true}};
+    }
+
+    void Sample(const World& world, std::vector<double>& values) override {
+        size_t n = world.GetPatchCount();
+        double resource = 0.0, danger = 0.0;
+        int zone_patches[3] = {0, 0, 0};
+        for (size_t j = 0; j < n; ++j) {
+            resource += world.GetResourceLevel(j);
+            danger += world.GetDangerLevel(j);
+            zone_patches[world.GetZone(j)]++;
+        }
+        values.push_back(n > 0 ? resource / n : 0.0);
+        values.push_back(n > 0 ? danger / n : 0.0);
+        for (int count : zone_patches) values.push_back(count);
+    }
+};
+
+// Prey caught in the sampled generation and the predators and prey left
+// after it, for worlds with predation (World::EnablePredation).
+class PredationObserver : public Observer {
+public:
+    std::vector<DataColumn> Columns() const override {
+        return {{"Captures", true}, {"Predators", true}, {"Prey", true}};
+    }
+
+    void Sample(const World& world, std::vector<double>& values) override {
+        values.push_back(static_cast<double>(world.GetLastCaptureCount()));
+        values.push_back(world.GetPredatorCount());
+        values.push_back(world.GetPrey1Count() + world.GetPrey2Count());
+    }
+};
+
+// Phase timings (microseconds) and event counts of the last Step, from
+// World::GetStepProfile. All zero unless built with -DWORLD_PROFILE.
+// RngDraws is stored as a float column, since it can outgrow the int32
+// counts of .ppcol files on large worlds.
+class StepProfileObserver : public Observer {
+public:
+    std::vector<DataColumn> Columns() const override {
+        return {{"MoveMicros"}, {"PredationMicros"}, {"ReproduceMicros"}, {"CullMicros"}, {"EnvironmentMicros"},
+                {"MovesAttempted", true}, {"MovesBlocked", true},
+                {"OffspringGenerated", true}, {"OffspringDiscarded", true},
+                {"Deaths", true}, {"RngDraws"}, {"ZoneChanges", true}, {"Hunts", true}, {"Captures", true}};
+    }
+
+    void Sample(const World& world, std::vector<double>& values) override {
+        const StepProfile& profile = world.GetStepProfile();
+        values.push_back(profile.move_seconds * 1e6);
+        values.push_back(profile.predation_seconds * 1e6);
+        values.push_back(profile.reproduce_seconds * 1e6);
+        values.push_back(profile.cull_seconds * 1e6);
+        values.push_back(profile.environment_seconds * 1e6);
+        values.push_back(static_cast<double>(profile.counters.moves_attempted));
+        values.push_back(static_cast<double>(profile.counters.moves_blocked));
+        values.push_back(static_cast<double>(profile.counters.offspring_generated));
+        values.push_back(static_cast<double>(profile.counters.offspring_discarded));
+        values.push_back(static_cast<double>(profile.counters.deaths));
+        values.push_back(static_cast<double>(profile.counters.rng_draws));
+        values.push_back(static_cast<double>(profile.counters.zone_changes));
+        values.push_back(static_cast<double>(profile.counters.hunts));
+        values.push_back(static_cast<double>(profile.counters.captures));
+    }
+};
+
+// Registry of observers, each with its own sink and sampling interval.
+// Call Collect after every Step; an observer runs only on generations that
+// are multiples of its interval, and nothing runs when none is due.
+// Give each observer its own sink, since sinks expect one column layout.
+class DataCollector {
+private:
+    struct Registration {
+        std::unique_ptr<Observer> observer;
+        std::shared_ptr<DataSink> sink;
+        uint64_t interval;
+        std::vector<double> values;
+    };
+    std::vector<Registration> registrations;
+
+public:
+    void Add(std::unique_ptr<Observer> observer, std::shared_ptr<DataSink> sink, uint64_t interval = 1) {
+        sink->Begin(observer->Columns());
+        registrations.push_back({std::move(observer), std::move(sink), std::max<uint64_t>(1, interval), {}});
+    }
+
+    void Collect(const World& world, uint64_t generation) {
+        for (Registration& reg : registrations) {
+            if (generation % reg.interval != 0) continue;
+            reg.values.clear();
+            reg.observer->Sample(world, reg.values);
+            reg.sink->Write(generation, reg.values);
+        }
+    }
+
+    void Flush() {
+        for (Registration& reg : registrations) reg.sink->Flush();
+    }
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef DATA_SINK_H
+#define DATA_SINK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+
+// One output column of an observer. Count columns are printed as integers.
+struct DataColumn {
+    std::string name;
+    bool is_count = false;
+};
+
+// Destination for the rows produced by one observer. Begin is called once
+// with the observer's columns, then Write once per sampled generation.
+class DataSink {
+public:
+    virtual ~DataSink() = default;
+    virtual void Begin(const std::vector<DataColumn>& columns) = 0;
+    virtual void Write(uint64_t generation, const std::vector<double>& values) = 0;
+    virtual void Flush() {}
+};
+
+// Comma-separated file with a "Generation,<columns>" header row.
+class CsvSink : public DataSink {
+private:
+    std::ofstream file;
+    std::vector<DataColumn> columns;
+
+public:
+    explicit CsvSink(const std::string& path) : file(path) {}
+
+    void Begin(const std::vector<DataColumn>& cols) override {
+        columns = cols;
+        file << "Generation";
+        for (const DataColumn& column : columns) file << "," << column.name;
+        file << "\n";
+    }
+
+    void Write(uint64_t generation, const std::vector<double>& values) override {
+        file << generation;
+        for (size_t k = 0; k < values.size(); ++k) {
+            file << ",";
+            if (columns[k].is_count) file << static_cast<long long>(values[k]);
+            else file << values[k];
+        }
+        file << "\n";
+    }
+
+    void Flush() override { file.flush(); }
+};
+
+// Tab-separated rows on a console stream, using the stream's own number
+// formatting, with no header. With a minimum interval, rows arriving less
+// than min_seconds after the last printed row are held back (only the
+// latest is kept) and printed on Flush, so the console shows progress and
+// the final row without a flush every generation.
+class ConsoleSink : public DataSink {
+private:
+    std::ostream& out;
+    std::vector<DataColumn> columns;
+    std::chrono::duration<double> min_interval;
+    std::chrono::steady_clock::time_point last_print;
+    bool printed = false;
+    bool has_pending = false;
+    uint64_t pending_generation = 0;
+    std::vector<double> pending_values;
+
+    void Print(uint64_t generation, const std::vector<double>& values) {
+        out << generation;
+        for (size_t k = 0; k < values.size(); ++k) {
+            out << "\t";
+            if (columns[k].is_count) out << static_cast<long long>(values[k]);
+            else out << values[k];
+        }
+        out << "\n";
+        out.flush();
+    }
+
+public:
+    explicit ConsoleSink(std::ostream& stream = std::cout, double min_seconds = 0.0)
+        : out(stream), min_interval(min_seconds) {}
+
+    void Begin(const std::vector<DataColumn>& cols) override { columns = cols; }
+
+    void Write(uint64_t generation, const std::vector<double>& values) override {
+        auto now = std::chrono::steady_clock::now();
+        if (printed && now - last_print < min_interval) {
+            has_pending = true;
+            pending_generation = generation;
+            pending_values = values;
+            return;
+        }
+        printed = true;
+        has_pending = false;
+        last_print = now;
+        Print(generation, values);
+    }
+
+    void Flush() override {
+        if (!has_pending) return;
+        has_pending = false;
+        Print(pending_generation, pending_values);
+    }
+};
+
+#endif
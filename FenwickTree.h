@@ -0,0 +1,65 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include <vector>
+#include <cstddef>
+
+// Binary indexed tree over non-negative weights. Supports point updates,
+// prefix sums and weighted index sampling in O(log n).
+class FenwickTree {
+private:
+    std::vector<double> tree; // 1-based partial sums.
+    double total = 0.0;
+
+public:
+    // Rebuilds the tree from a list of weights in O(n).
+    void Assign(const std::vector<double>& weights) {
+        size_t n = weights.size();
+        tree.assign(n + 1, 0.0);
+        total = 0.0;
+        for (size_t i = 1; i <= n; ++i) {
+            tree[i] += weights[i - 1];
+            total += weights[i - 1];
+            size_t parent = i + (i & (~i + 1));
+            if (parent <= n) tree[parent] += tree[i];
+        }
+    }
+
+    // Adds delta to the weight at index.
+    void Add(size_t index, double delta) {
+        total += delta;
+        for (size_t i = index + 1; i < tree.size(); i += (i & (~i + 1))) {
+            tree[i] += delta;
+        }
+    }
+
+    // Returns the sum of the first count weights.
+    double PrefixSum(size_t count) const {
+        double sum = 0.0;
+        for (size_t i = count; i > 0; i -= (i & (~i + 1))) sum += tree[i];
+        return sum;
+    }
+
+    // Returns the smallest index whose inclusive prefix sum exceeds target.
+    // For target drawn uniformly from [0, Total()) this samples an index in
+    // proportion to its weight; zero-weight indices are never returned.
+    size_t Find(double target) const {
+        size_t n = Size();
+        size_t step = 1;
+        while (step * 2 <= n) step *= 2;
+
+        size_t pos = 0;
+        for (; step > 0; step /= 2) {
+            if (pos + step <= n && tree[pos + step] <= target) {
+                pos += step;
+                target -= tree[pos];
+            }
+        }
+        return pos < n ? pos : n - 1; // Guard against rounding at the top end.
+    }
+
+    double Total() const { return total; }
+    size_t Size() const { return tree.empty() ? 0 : tree.size() - 1; }
+};
+
+#endif
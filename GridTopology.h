@@ -0,0 +1,197 @@
+#ifndef GRID_TOPOLOGY_H
+#define GRID_TOPOLOGY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Which patches an organism can reach in one step. Global is the original
+// rule: any patch in the world. Moore covers the (2k+1) x (2k+1) square
+// around a patch, VonNeumann the diamond |dx| + |dy| <= k.
+enum class Neighborhood { Global, Moore, VonNeumann };
+
+// Bounded grids stop at their edges; Torus grids wrap around them.
+enum class GridEdges { Bounded, Torus };
+
+// Order in which patches are stored. RowMajor is index y * width + x.
+// Morton (Z-order) and Hilbert follow a space-filling curve, so patches
+// that are close on the grid are close in memory; the Hilbert curve never
+// jumps, Morton is cheaper to compute. Curve orders are ranked densely, so
+// any width and height work, not just powers of two.
+enum class PatchOrder { RowMajor, Morton, Hilbert };
+
+// Geometry of a width x height grid of patches, the order they are stored
+// in, and the neighborhood used by local movement and offspring placement.
+// Patch indices are storage indices; Index, X and Y convert to and from
+// coordinates, and RowMajorIndex / FromRowMajor to and from the row-major
+// numbering used for output.
+class GridTopology {
+private:
+    size_t width = 0;
+    size_t height = 1;
+    PatchOrder order = PatchOrder::RowMajor;
+    std::vector<uint32_t> to_storage;   // Row-major index -> patch index, curve orders only.
+    std::vector<uint32_t> to_row_major; // Patch index -> row-major index, curve orders only.
+    Neighborhood neighborhood = Neighborhood::Global;
+    int radius = 1;
+    GridEdges edges = GridEdges::Bounded;
+    std::vector<std::pair<int, int>> offsets; // (dx, dy) in the neighborhood, (0, 0) included.
+
+    static uint64_t MortonCode(uint32_t x, uint32_t y) {
+        auto spread = [](uint64_t v) {
+            v &= 0xFFFFFFFFull;
+            v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+            v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+            v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+            v = (v | (v << 2)) & 0x3333333333333333ull;
+            v = (v | (v << 1)) & 0x5555555555555555ull;
+            return v;
+        };
+        return spread(x) | (spread(y) << 1);
+    }
+
+    // Distance along the Hilbert curve filling an n x n square (n a power
+    // of two).
+    static uint64_t HilbertCode(uint64_t n, uint64_t x, uint64_t y) {
+        uint64_t d = 0;
+        for (uint64_t s = n / 2; s > 0; s /= 2) {
+            uint64_t rx = (x & s) > 0;
+            uint64_t ry = (y & s) > 0;
+            d += s * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    // Ranks every cell by its curve code, giving dense patch indices.
+    void BuildOrderTables() {
+        to_storage.clear();
+        to_row_major.clear();
+        if (order == PatchOrder::RowMajor) return;
+        uint64_t n = 1;
+        while (n < width || n < height) n *= 2;
+        std::vector<std::pair<uint64_t, uint32_t>> cells(width * height);
+        for (size_t r = 0; r < cells.size(); ++r) {
+            uint64_t x = r % width, y = r / width;
+            uint64_t code = order == PatchOrder::Morton ? MortonCode(static_cast<uint32_t>(x), static_cast<uint32_t>(y))
+                                                        : HilbertCode(n, x, y);
+            cells[r] = {code, static_cast<uint32_t>(r)};
+        }
+        std::sort(cells.begin(), cells.end());
+        to_storage.resize(cells.size());
+        to_row_major.resize(cells.size());
+        for (size_t i = 0; i < cells.size(); ++i) {
+            to_row_major[i] = cells[i].second;
+            to_storage[cells[i].second] = static_cast<uint32_t>(i);
+        }
+    }
+
+    void BuildOffsets() {
+        offsets.clear();
+        if (neighborhood == Neighborhood::Global) return;
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                if (neighborhood == Neighborhood::VonNeumann && std::abs(dx) + std::abs(dy) > radius) continue;
+                offsets.push_back({dx, dy});
+            }
+        }
+    }
+
+public:
+    GridTopology() = default;
+    GridTopology(size_t grid_width, size_t grid_height, PatchOrder patch_order = PatchOrder::RowMajor)
+        : width(grid_width), height(grid_height), order(patch_order) {
+        BuildOrderTables();
+    }
+
+    // A torus wraps only along sides of 3 or more patches, as in
+    // ForEachAdjacent, and the radius is capped by those sides so that no
+    // patch is reached twice.
+    void SetNeighborhood(Neighborhood kind, int k, GridEdges edge_mode) {
+        neighborhood = kind;
+        edges = edge_mode;
+        radius = std::max(1, k);
+        if (edges == GridEdges::Torus) {
+            for (size_t side : {width, height}) {
+                if (side >= 3) radius = std::min(radius, static_cast<int>((side - 1) / 2));
+            }
+        }
+        BuildOffsets();
+    }
+
+    size_t Width() const { return width; }
+    size_t Height() const { return height; }
+    Neighborhood GetNeighborhood() const { return neighborhood; }
+    int Radius() const { return radius; }
+    GridEdges Edges() const { return edges; }
+    bool IsLocal() const { return neighborhood != Neighborhood::Global; }
+
+    PatchOrder Order() const { return order; }
+
+    size_t FromRowMajor(size_t r) const { return to_storage.empty() ? r : to_storage[r]; }
+    size_t RowMajorIndex(size_t i) const { return to_row_major.empty() ? i : to_row_major[i]; }
+    size_t Index(size_t x, size_t y) const { return FromRowMajor(y * width + x); }
+    size_t X(size_t i) const { return RowMajorIndex(i) % width; }
+    size_t Y(size_t i) const { return RowMajorIndex(i) / width; }
+
+    // Calls f(j) for every patch j in i's neighborhood, i included, in
+    // row-major order of offsets, each patch once. Cells off a bounded
+    // grid, or off a torus side too short to wrap, are skipped.
+    template <typename F>
+    void ForEachNeighbor(size_t i, F&& f) const {
+        size_t r = RowMajorIndex(i);
+        long x = static_cast<long>(r % width);
+        long y = static_cast<long>(r / width);
+        long w = static_cast<long>(width);
+        long h = static_cast<long>(height);
+        bool wrap_x = edges == GridEdges::Torus && w >= 3;
+        bool wrap_y = edges == GridEdges::Torus && h >= 3;
+        for (const auto& [dx, dy] : offsets) {
+            long nx = x + dx;
+            long ny = y + dy;
+            if (wrap_x) nx = (nx + w) % w;
+            else if (nx < 0 || nx >= w) continue;
+            if (wrap_y) ny = (ny + h) % h;
+            else if (ny < 0 || ny >= h) continue;
+            f(FromRowMajor(static_cast<size_t>(ny * w + nx)));
+        }
+    }
+
+    // Calls f(j) for each of the (up to) 8 patches touching i, whatever the
+    // movement neighborhood, in row-major order of offsets. A torus wraps
+    // only along sides of 3 or more patches, so no patch is visited twice
+    // and i itself never is; a 1-row world gives i - 1 and i + 1.
+    template <typename F>
+    void ForEachAdjacent(size_t i, F&& f) const {
+        size_t r = RowMajorIndex(i);
+        long x = static_cast<long>(r % width);
+        long y = static_cast<long>(r / width);
+        long w = static_cast<long>(width);
+        long h = static_cast<long>(height);
+        bool wrap_x = edges == GridEdges::Torus && w >= 3;
+        bool wrap_y = edges == GridEdges::Torus && h >= 3;
+        for (long dy = -1; dy <= 1; ++dy) {
+            long ny = y + dy;
+            if (wrap_y) ny = (ny + h) % h;
+            else if (ny < 0 || ny >= h) continue;
+            for (long dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dy == 0) continue;
+                long nx = x + dx;
+                if (wrap_x) nx = (nx + w) % w;
+                else if (nx < 0 || nx >= w) continue;
+                f(FromRowMajor(static_cast<size_t>(ny * w + nx)));
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef OCCUPANCY_BITMAP_H
+#define OCCUPANCY_BITMAP_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// One bit per patch. Finding the next set or clear bit scans whole 64-bit
+// words with bit-scan instructions, so walking only occupied patches or
+// finding the nearest free patch skips empty stretches 64 patches at a time.
+class OccupancyBitmap {
+private:
+    std::vector<uint64_t> words;
+    size_t num_bits = 0;
+    size_t num_set = 0;
+
+    static size_t LowestBit(uint64_t word) { return static_cast<size_t>(__builtin_ctzll(word)); }
+    static size_t HighestBit(uint64_t word) { return 63 - static_cast<size_t>(__builtin_clzll(word)); }
+
+    // Word w with bits past the end treated as set, so they never look free.
+    uint64_t FreeBits(size_t w) const {
+        uint64_t free_bits = ~words[w];
+        size_t tail = num_bits - w * 64;
+        if (tail < 64) free_bits &= (uint64_t(1) << tail) - 1;
+        return free_bits;
+    }
+
+public:
+    OccupancyBitmap(size_t size = 0) { Resize(size); }
+
+    void Resize(size_t size) {
+        num_bits = size;
+        words.assign((size + 63) / 64, 0);
+        num_set = 0;
+    }
+
+    void ClearAll() {
+        std::fill(words.begin(), words.end(), 0);
+        num_set = 0;
+    }
+
+    bool Test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+
+    void Set(size_t i) {
+        uint64_t bit = uint64_t(1) << (i % 64);
+        if (!(words[i / 64] & bit)) num_set++;
+        words[i / 64] |= bit;
+    }
+
+    void Reset(size_t i) {
+        uint64_t bit = uint64_t(1) << (i % 64);
+        if (words[i / 64] & bit) num_set--;
+        words[i / 64] &= ~bit;
+    }
+
+    size_t Size() const { return num_bits; }
+    size_t CountSet() const { return num_set; }
+    size_t CountFree() const { return num_bits - num_set; }
+
+    // First set bit at or after i, or Size() if there is none.
+    size_t NextSet(size_t i) const {
+        if (i >= num_bits) return num_bits;
+        size_t w = i / 64;
+        uint64_t word = words[w] & (~uint64_t(0) << (i % 64));
+        while (!word) {
+            if (++w == words.size()) return num_bits;
+            word = words[w];
+        }
+        return w * 64 + LowestBit(word);
+    }
+
+    // First clear bit at or after i, or Size() if there is none.
+    size_t NextFree(size_t i) const {
+        if (i >= num_bits) return num_bits;
+        size_t w = i / 64;
+        uint64_t word = FreeBits(w) & (~uint64_t(0) << (i % 64));
+        while (!word) {
+            if (++w == words.size()) return num_bits;
+            word = FreeBits(w);
+        }
+        return w * 64 + LowestBit(word);
+    }
+
+    // Last clear bit at or before i, or Size() if there is none.
+    size_t PrevFree(size_t i) const {
+        if (num_bits == 0) return num_bits;
+        if (i >= num_bits) i = num_bits - 1;
+        size_t w = i / 64;
+        uint64_t word = FreeBits(w) & (~uint64_t(0) >> (63 - i % 64));
+        while (!word) {
+            if (w-- == 0) return num_bits;
+            word = FreeBits(w);
+        }
+        return w * 64 + HighestBit(word);
+    }
+
+    // Clear bit closest to i in index distance (ties go to the lower index),
+    // or Size() if every bit is set.
+    size_t NearestFree(size_t i) const {
+        size_t after = NextFree(i);
+        size_t before = PrevFree(i);
+        if (before == num_bits) return after;
+        if (after == num_bits) return before;
+        return (after - i < i - before) ? after : before;
+    }
+
+    // Calls func(i) for every set bit in increasing order.
+    template <typename Func>
+    void ForEachSet(Func&& func) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t word = words[w];
+            while (word) {
+                func(w * 64 + LowestBit(word));
+                word &= word - 1;
+            }
+        }
+    }
+};
+
+#endif
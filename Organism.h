@@ -1,6 +1,11 @@
 #ifndef ORGANISM_H
 #define ORGANISM_H
 
+#include <cstdint>
+
+// Concrete organism types, used as the species tag in World's organism store.
+enum class Species : uint8_t { Prey, Prey2, Predator };
+
 // Base class for all organisms (prey and predators).
 class Organism {
 protected:
@@ -26,6 +31,8 @@ public:
 
     // Returns true if prey, false if predator.
     virtual bool IsPrey() const = 0;
+    // Returns the concrete organism type.
+    virtual Species GetSpecies() const = 0;
     // Sets organism's alpha trait.
     virtual void SetAlpha(double new_alpha) = 0;
     // Creates a copy of the organism.
@@ -0,0 +1,197 @@
+#ifndef ORGANISM_STORE_H
+#define ORGANISM_STORE_H
+
+#include "Organism.h"
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+// Stable reference to an organism in an OrganismStore. Stays valid until the
+// organism is removed; a removed organism's handle never matches a later one.
+struct OrganismHandle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const OrganismHandle& other) const {
+        return slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const OrganismHandle& other) const { return !(*this == other); }
+};
+
+// Structure-of-arrays organism storage. Live organisms are packed into
+// parallel arrays indexed 0..Size()-1, so per-step loops touch only the
+// traits they need. The arrays are segregated by species: all Prey, then
+// all Prey2, then all Predators, so a loop over one species is a loop over
+// one contiguous range. Insertion and removal keep the segments packed
+// with at most one move per segment boundary; this changes dense indices
+// but never handles. Freed slots go on a free list and are reused.
+class OrganismStore {
+private:
+    static constexpr size_t num_species = 3;
+
+    // Dense per-organism arrays.
+    std::vector<double> alpha;
+    std::vector<double> tau;
+    std::vector<double> move_rate;
+    std::vector<int8_t> birth_zone;
+    std::vector<Species> species;
+    std::vector<size_t> patch;
+    std::vector<uint32_t> dense_slot;
+
+    // Slot table mapping handles to dense indices.
+    std::vector<uint32_t> slot_dense;
+    std::vector<uint32_t> slot_generation;
+    std::vector<uint32_t> free_slots;
+
+    // segment_begin[s] is the first dense index of species s; the last entry
+    // is the total size.
+    std::array<size_t, num_species + 1> segment_begin{};
+
+    void MoveEntry(size_t from, size_t to) {
+        alpha[to] = alpha[from];
+        tau[to] = tau[from];
+        move_rate[to] = move_rate[from];
+        birth_zone[to] = birth_zone[from];
+        species[to] = species[from];
+        patch[to] = patch[from];
+        dense_slot[to] = dense_slot[from];
+        slot_dense[dense_slot[to]] = static_cast<uint32_t>(to);
+    }
+
+    void SwapEntries(size_t i, size_t j) {
+        std::swap(alpha[i], alpha[j]);
+        std::swap(tau[i], tau[j]);
+        std::swap(move_rate[i], move_rate[j]);
+        std::swap(birth_zone[i], birth_zone[j]);
+        std::swap(species[i], species[j]);
+        std::swap(patch[i], patch[j]);
+        std::swap(dense_slot[i], dense_slot[j]);
+        slot_dense[dense_slot[i]] = static_cast<uint32_t>(i);
+        slot_dense[dense_slot[j]] = static_cast<uint32_t>(j);
+    }
+
+public:
+    void Reserve(size_t capacity) {
+        alpha.reserve(capacity);
+        tau.reserve(capacity);
+        move_rate.reserve(capacity);
+        birth_zone.reserve(capacity);
+        species.reserve(capacity);
+        patch.reserve(capacity);
+        dense_slot.reserve(capacity);
+        slot_dense.reserve(capacity);
+        slot_generation.reserve(capacity);
+    }
+
+    OrganismHandle Add(Species s, double a, double t, double m, int zone, size_t patch_index) {
+        uint32_t slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slot_dense.size());
+            slot_dense.push_back(0);
+            slot_generation.push_back(0);
+        }
+        slot_dense[slot] = static_cast<uint32_t>(alpha.size());
+
+        alpha.push_back(a);
+        tau.push_back(t);
+        move_rate.push_back(s == Species::Prey2 ? 0.0 : m); // Prey2 never moves.
+        birth_zone.push_back(static_cast<int8_t>(zone));
+        species.push_back(s);
+        patch.push_back(patch_index);
+        dense_slot.push_back(slot);
+
+        // Rotate the new entry down into its species segment, shifting the
+        // first entry of each later segment to that segment's end.
+        size_t pos = alpha.size() - 1;
+        for (size_t k = num_species - 1; k > static_cast<size_t>(s); --k) {
+            SwapEntries(pos, segment_begin[k]);
+            pos = segment_begin[k]++;
+        }
+        segment_begin[num_species] = alpha.size();
+        return {slot, slot_generation[slot]};
+    }
+
+    // Removes the organism at dense index i. The last entry of its segment
+    // fills the hole, and each later segment passes its last entry down the
+    // same way, so only entries after i move. Loops that remove while
+    // iterating should therefore run backwards.
+    void RemoveAt(size_t i) {
+        uint32_t slot = dense_slot[i];
+        slot_generation[slot]++;
+        free_slots.push_back(slot);
+
+        size_t hole = i;
+        for (size_t k = static_cast<size_t>(species[i]); k < num_species; ++k) {
+            size_t last = segment_begin[k + 1] - 1;
+            if (last != hole) MoveEntry(last, hole);
+            hole = last;
+            segment_begin[k + 1]--;
+        }
+        alpha.pop_back();
+        tau.pop_back();
+        move_rate.pop_back();
+        birth_zone.pop_back();
+        species.pop_back();
+        patch.pop_back();
+        dense_slot.pop_back();
+    }
+
+    void Remove(OrganismHandle h) {
+        if (IsValid(h)) RemoveAt(slot_dense[h.slot]);
+    }
+
+    void Clear() {
+        for (uint32_t slot : dense_slot) {
+            slot_generation[slot]++;
+            free_slots.push_back(slot);
+        }
+        alpha.clear();
+        tau.clear();
+        move_rate.clear();
+        birth_zone.clear();
+        species.clear();
+        patch.clear();
+        dense_slot.clear();
+        segment_begin.fill(0);
+    }
+
+    bool IsValid(OrganismHandle h) const {
+        return h.slot < slot_generation.size() && slot_generation[h.slot] == h.generation;
+    }
+
+    // Dense index of a valid handle.
+    size_t IndexOf(OrganismHandle h) const { return slot_dense[h.slot]; }
+    OrganismHandle HandleAt(size_t i) const { return {dense_slot[i], slot_generation[dense_slot[i]]}; }
+
+    // Slot lookups for callers that store only the 32-bit slot of a live
+    // organism, such as World's per-patch occupant array.
+    uint32_t SlotAt(size_t i) const { return dense_slot[i]; }
+    size_t IndexOfSlot(uint32_t slot) const { return slot_dense[slot]; }
+    OrganismHandle HandleOfSlot(uint32_t slot) const { return {slot, slot_generation[slot]}; }
+
+    size_t Size() const { return alpha.size(); }
+
+    // Dense index range [SpeciesBegin(s), SpeciesEnd(s)) holding species s.
+    size_t SpeciesBegin(Species s) const { return segment_begin[static_cast<size_t>(s)]; }
+    size_t SpeciesEnd(Species s) const { return segment_begin[static_cast<size_t>(s) + 1]; }
+    size_t Count(Species s) const { return SpeciesEnd(s) - SpeciesBegin(s); }
+    // All prey (Prey and Prey2) form the range [0, PreyEnd()).
+    size_t PreyEnd() const { return SpeciesBegin(Species::Predator); }
+
+    double GetAlpha(size_t i) const { return alpha[i]; }
+    double GetTau(size_t i) const { return tau[i]; }
+    double GetMoveRate(size_t i) const { return move_rate[i]; }
+    int GetBirthZone(size_t i) const { return birth_zone[i]; }
+    Species GetSpecies(size_t i) const { return species[i]; }
+    bool IsPrey(size_t i) const { return species[i] != Species::Predator; }
+    size_t GetPatch(size_t i) const { return patch[i]; }
+
+    void SetPatch(size_t i, size_t patch_index) { patch[i] = patch_index; }
+    void SetBirthZone(size_t i, int zone) { birth_zone[i] = static_cast<int8_t>(zone); }
+};
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef PATCH_SCORE_KERNEL_H
+#define PATCH_SCORE_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+// Full-scan patch scoring over flat per-patch arrays. The score of patch j is
+//   alpha * (tau * (resource_weight * R_j + prey_weight * prey_j) - (1 - tau) * D_j)
+// and is zero when a zone filter is set and zone_j differs from it. D_j is
+// the predator count, plus the danger field when one is given. Prey score
+// resource (resource_weight 1, prey_weight 0, no filter) and may see a
+// danger field; predators score prey counts inside their birth zone
+// (resource_weight 0, prey_weight 1), the zone test being a vector mask.
+//
+// Total() and Find() are vectorized with AVX-512 or AVX2 on native builds and
+// SIMD128 on wasm builds, with a scalar fallback. Find() keeps the running
+// sum in registers using an in-register prefix scan, so it handles negative
+// scores the same way as the scalar roulette loop: it returns the first
+// patch whose running total reaches the target. If rounding leaves the
+// running total just short of a target drawn below Total(), Find() returns
+// the last patch with a positive score rather than no patch.
+class PatchScoreKernel {
+private:
+    const float* resource;
+    const uint8_t* prey_count;
+    const uint8_t* predator_count;
+    const int8_t* zone;
+    const float* danger = nullptr;
+    size_t count;
+
+    double alpha = 0.0;
+    double tau = 0.0;
+    double resource_weight = 1.0;
+    double prey_weight = 0.0;
+    int zone_filter = -1;
+
+    double ScoreAt(size_t j) const {
+        if (zone_filter >= 0 && zone[j] != zone_filter) return 0.0;
+        double food = resource_weight * resource[j] + prey_weight * static_cast<double>(prey_count[j]);
+        double threat = static_cast<double>(predator_count[j]);
+        if (danger) threat += danger[j];
+        return alpha * (tau * food - (1 - tau) * threat);
+    }
+
+#if defined(__AVX512F__)
+    static constexpr size_t lanes = 8;
+    // The AVX-512 code uses the zero-masking forms of the intrinsics, with
+    // every lane kept, where the plain forms pass an undefined vector that
+    // GCC 12 reports under -Wmaybe-uninitialized. The instructions are the
+    // same.
+    static constexpr __mmask8 all_lanes = 0xFF;
+
+    static __m512d LoadCounts(const uint8_t* counts) {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(counts));
+        return _mm512_maskz_cvtepi32_pd(all_lanes, _mm256_cvtepu8_epi32(bytes));
+    }
+
+    static __m512d LoadFloats(const float* values) {
+        return _mm512_maskz_cvtps_pd(all_lanes, _mm256_loadu_ps(values));
+    }
+
+    __m512d ScoreBlock(size_t j) const {
+        __m512d r = LoadFloats(resource + j);
+        __m512d prey = LoadCounts(prey_count + j);
+        __m512d pred = LoadCounts(predator_count + j);
+        if (danger) pred = _mm512_add_pd(pred, LoadFloats(danger + j));
+        __m512d food = _mm512_add_pd(_mm512_mul_pd(_mm512_set1_pd(resource_weight), r),
+                                     _mm512_mul_pd(_mm512_set1_pd(prey_weight), prey));
+        __m512d inner = _mm512_sub_pd(_mm512_mul_pd(_mm512_set1_pd(tau), food),
+                                      _mm512_mul_pd(_mm512_set1_pd(1 - tau), pred));
+        __m512d s = _mm512_mul_pd(_mm512_set1_pd(alpha), inner);
+        if (zone_filter >= 0) {
+            __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(zone + j));
+            __m512i z = _mm512_maskz_cvtepi8_epi64(all_lanes, bytes);
+            __mmask8 keep = _mm512_cmpeq_epi64_mask(z, _mm512_set1_epi64(zone_filter));
+            s = _mm512_maskz_mov_pd(keep, s);
+        }
+        return s;
+    }
+#elif defined(__AVX2__)
+    static constexpr size_t lanes = 4;
+
+    static __m256d LoadCounts(const uint8_t* counts) {
+        int32_t bytes;
+        std::memcpy(&bytes, counts, sizeof(bytes));
+        return _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)));
+    }
+
+    __m256d ScoreBlock(size_t j) const {
+        __m256d r = _mm256_cvtps_pd(_mm_loadu_ps(resource + j));
+        __m256d prey = LoadCounts(prey_count + j);
+        __m256d pred = LoadCounts(predator_count + j);
+        if (danger) pred = _mm256_add_pd(pred, _mm256_cvtps_pd(_mm_loadu_ps(danger + j)));
+        __m256d food = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(resource_weight), r),
+                                     _mm256_mul_pd(_mm256_set1_pd(prey_weight), prey));
+        __m256d inner = _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(tau), food),
+                                      _mm256_mul_pd(_mm256_set1_pd(1 - tau), pred));
+        __m256d s = _mm256_mul_pd(_mm256_set1_pd(alpha), inner);
+        if (zone_filter >= 0) {
+            int32_t zone4;
+            std::memcpy(&zone4, zone + j, sizeof(zone4));
+            __m256i z = _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(zone4));
+            __m256i keep = _mm256_cmpeq_epi64(z, _mm256_set1_epi64x(zone_filter));
+            s = _mm256_and_pd(s, _mm256_castsi256_pd(keep));
+        }
+        return s;
+    }
+#elif defined(__wasm_simd128__)
+    static constexpr size_t lanes = 2;
+
+    v128_t ScoreBlock(size_t j) const {
+        v128_t r = wasm_f64x2_promote_low_f32x4(wasm_v128_load64_zero(resource + j));
+        v128_t prey = wasm_f64x2_make(prey_count[j], prey_count[j + 1]);
+        v128_t pred = wasm_f64x2_make(predator_count[j], predator_count[j + 1]);
+        if (danger) pred = wasm_f64x2_add(pred, wasm_f64x2_promote_low_f32x4(wasm_v128_load64_zero(danger + j)));
+        v128_t food = wasm_f64x2_add(wasm_f64x2_mul(wasm_f64x2_splat(resource_weight), r),
+                                     wasm_f64x2_mul(wasm_f64x2_splat(prey_weight), prey));
+        v128_t inner = wasm_f64x2_sub(wasm_f64x2_mul(wasm_f64x2_splat(tau), food),
+                                      wasm_f64x2_mul(wasm_f64x2_splat(1 - tau), pred));
+        v128_t s = wasm_f64x2_mul(wasm_f64x2_splat(alpha), inner);
+        if (zone_filter >= 0) {
+            v128_t keep = wasm_i64x2_make(zone[j] == zone_filter ? -1 : 0,
+                                          zone[j + 1] == zone_filter ? -1 : 0);
+            s = wasm_v128_and(s, keep);
+        }
+        return s;
+    }
+#else
+    static constexpr size_t lanes = 1;
+#endif
+
+public:
+    PatchScoreKernel(const float* resource_levels, const uint8_t* prey_counts,
+                     const uint8_t* predator_counts, const int8_t* zones, size_t num_patches)
+        : resource(resource_levels), prey_count(prey_counts),
+          predator_count(predator_counts), zone(zones), count(num_patches) {}
+
+    // danger_field, if given, adds to every patch's predator count.
+    void SetPreyScoring(double a, double t, const float* danger_field = nullptr) {
+        alpha = a;
+        tau = t;
+        resource_weight = 1.0;
+        prey_weight = 0.0;
+        zone_filter = -1;
+        danger = danger_field;
+    }
+
+    void SetPredatorScoring(double a, double t, int birth_zone) {
+        alpha = a;
+        tau = t;
+        resource_weight = 0.0;
+        prey_weight = 1.0;
+        zone_filter = birth_zone;
+        danger = nullptr;
+    }
+
+    // Returns the sum of all patch scores.
+    double Total() const {
+        size_t j = 0;
+        double total = 0.0;
+#if defined(__AVX512F__)
+        __m512d acc = _mm512_setzero_pd();
+        for (; j + lanes <= count; j += lanes) acc = _mm512_add_pd(acc, ScoreBlock(j));
+        __m256d folded = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(all_lanes, acc, 0),
+                                       _mm512_maskz_extractf64x4_pd(all_lanes, acc, 1));
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(folded), _mm256_extractf128_pd(folded, 1));
+        total = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+#elif defined(__AVX2__)
+        __m256d acc = _mm256_setzero_pd();
+        for (; j + lanes <= count; j += lanes) acc = _mm256_add_pd(acc, ScoreBlock(j));
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+        total = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+#elif defined(__wasm_simd128__)
+        v128_t acc = wasm_f64x2_splat(0.0);
+        for (; j + lanes <= count; j += lanes) acc = wasm_f64x2_add(acc, ScoreBlock(j));
+        total = wasm_f64x2_extract_lane(acc, 0) + wasm_f64x2_extract_lane(acc, 1);
+#endif
+        for (; j < count; ++j) total += ScoreAt(j);
+        return total;
+    }
+
+    // Returns the first patch whose running score total is >= target. If
+    // the running total never reaches it, returns the last patch with a
+    // positive score, or the patch count if there is none.
+    size_t Find(double target) const {
+        size_t j = 0;
+        double running_total = 0.0;
+        size_t last_positive = count;
+#if defined(__AVX512F__)
+        const __m512i shift1 = _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0);
+        const __m512i shift2 = _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0);
+        const __m512i shift4 = _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0);
+        const __m512i last = _mm512_set1_epi64(7);
+        const __m512d goal = _mm512_set1_pd(target);
+        __m512d carry = _mm512_setzero_pd();
+        for (; j + lanes <= count; j += lanes) {
+            __m512d s = ScoreBlock(j);
+            __mmask8 positive = _mm512_cmp_pd_mask(s, _mm512_setzero_pd(), _CMP_GT_OQ);
+            if (positive) last_positive = j + 31 - __builtin_clz(positive);
+            s = _mm512_add_pd(s, _mm512_maskz_permutexvar_pd(0xFE, shift1, s));
+            s = _mm512_add_pd(s, _mm512_maskz_permutexvar_pd(0xFC, shift2, s));
+            s = _mm512_add_pd(s, _mm512_maskz_permutexvar_pd(0xF0, shift4, s));
+            __m512d prefix = _mm512_add_pd(s, carry);
+            __mmask8 reached = _mm512_cmp_pd_mask(prefix, goal, _CMP_GE_OQ);
+            if (reached) return j + __builtin_ctz(reached);
+            carry = _mm512_maskz_permutexvar_pd(all_lanes, last, prefix);
+        }
+        running_total = _mm512_cvtsd_f64(carry);
+#elif defined(__AVX2__)
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d goal = _mm256_set1_pd(target);
+        __m256d carry = zero;
+        for (; j + lanes <= count; j += lanes) {
+            __m256d s = ScoreBlock(j);
+            int positive = _mm256_movemask_pd(_mm256_cmp_pd(s, zero, _CMP_GT_OQ));
+            if (positive) last_positive = j + 31 - __builtin_clz(positive);
+            s = _mm256_add_pd(s, _mm256_blend_pd(_mm256_permute4x64_pd(s, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1));
+            s = _mm256_add_pd(s, _mm256_blend_pd(_mm256_permute4x64_pd(s, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x3));
+            __m256d prefix = _mm256_add_pd(s, carry);
+            int reached = _mm256_movemask_pd(_mm256_cmp_pd(prefix, goal, _CMP_GE_OQ));
+            if (reached) return j + __builtin_ctz(reached);
+            carry = _mm256_permute4x64_pd(prefix, 0xFF);
+        }
+        running_total = _mm256_cvtsd_f64(carry);
+#elif defined(__wasm_simd128__)
+        const v128_t zero = wasm_f64x2_splat(0.0);
+        const v128_t goal = wasm_f64x2_splat(target);
+        v128_t carry = zero;
+        for (; j + lanes <= count; j += lanes) {
+            v128_t s = ScoreBlock(j);
+            int positive = wasm_i64x2_bitmask(wasm_f64x2_gt(s, zero));
+            if (positive) last_positive = j + 31 - __builtin_clz(positive);
+            s = wasm_f64x2_add(s, wasm_i64x2_shuffle(zero, s, 0, 2));
+            v128_t prefix = wasm_f64x2_add(s, carry);
+            int reached = wasm_i64x2_bitmask(wasm_f64x2_ge(prefix, goal));
+            if (reached) return j + __builtin_ctz(reached);
+            carry = wasm_i64x2_shuffle(prefix, prefix, 1, 1);
+        }
+        running_total = wasm_f64x2_extract_lane(carry, 0);
+#endif
+        for (; j < count; ++j) {
+            double score = ScoreAt(j);
+            if (score > 0.0) last_positive = j;
+            running_total += score;
+            if (running_total >= target) return j;
+        }
+        return last_positive;
+    }
+};
+
+#endif
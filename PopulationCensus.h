@@ -0,0 +1,89 @@
+#ifndef POPULATION_CENSUS_H
+#define POPULATION_CENSUS_H
+
+#include <array>
+
+// Groups reported in statistics. Prey are split by trait rather than by
+// Species: Prey1 are prey with tau > 0.5, Prey2 the rest.
+enum class CensusGroup { Prey1, Prey2, Predator };
+
+// Live population totals per group and resource zone: organism counts and
+// alpha/tau sums. World updates it on every placement, move, birth and
+// death, so every read is O(1) and nothing rescans the population.
+// Traits never change after birth, so an organism stays in one group.
+class PopulationCensus {
+private:
+    static constexpr int num_groups = 3;
+    static constexpr int num_zones = 3;
+
+    std::array<std::array<int, num_zones>, num_groups> count{};
+    std::array<std::array<double, num_zones>, num_groups> alpha_sum{};
+    std::array<std::array<double, num_zones>, num_groups> tau_sum{};
+
+    static int Index(CensusGroup group) { return static_cast<int>(group); }
+
+public:
+    static CensusGroup GroupOf(bool is_prey, double tau) {
+        if (!is_prey) return CensusGroup::Predator;
+        return tau > 0.5 ? CensusGroup::Prey1 : CensusGroup::Prey2;
+    }
+
+    void Clear() {
+        for (auto& row : count) row.fill(0);
+        for (auto& row : alpha_sum) row.fill(0.0);
+        for (auto& row : tau_sum) row.fill(0.0);
+    }
+
+    void Add(CensusGroup group, int zone, double alpha, double tau) {
+        int g = Index(group);
+        count[g][zone]++;
+        alpha_sum[g][zone] += alpha;
+        tau_sum[g][zone] += tau;
+    }
+
+    void Remove(CensusGroup group, int zone, double alpha, double tau) {
+        int g = Index(group);
+        count[g][zone]--;
+        alpha_sum[g][zone] -= alpha;
+        tau_sum[g][zone] -= tau;
+        // Drop accumulated rounding once a cell empties.
+        if (count[g][zone] == 0) {
+            alpha_sum[g][zone] = 0.0;
+            tau_sum[g][zone] = 0.0;
+        }
+    }
+
+    int Count(CensusGroup group, int zone) const { return count[Index(group)][zone]; }
+
+    int Count(CensusGroup group) const {
+        const auto& row = count[Index(group)];
+        return row[0] + row[1] + row[2];
+    }
+
+    int PreyCount(int zone) const { return Count(CensusGroup::Prey1, zone) + Count(CensusGroup::Prey2, zone); }
+    int PredatorCount(int zone) const { return Count(CensusGroup::Predator, zone); }
+    int Total() const { return Count(CensusGroup::Prey1) + Count(CensusGroup::Prey2) + Count(CensusGroup::Predator); }
+
+    double AlphaSum(CensusGroup group) const {
+        const auto& row = alpha_sum[Index(group)];
+        return row[0] + row[1] + row[2];
+    }
+
+    double TauSum(CensusGroup group) const {
+        const auto& row = tau_sum[Index(group)];
+        return row[0] + row[1] + row[2];
+    }
+
+    // Means over the whole group, 0 for an empty group.
+    double MeanAlpha(CensusGroup group) const {
+        int n = Count(group);
+        return n > 0 ? AlphaSum(group) / n : 0.0;
+    }
+
+    double MeanTau(CensusGroup group) const {
+        int n = Count(group);
+        return n > 0 ? TauSum(group) / n : 0.0;
+    }
+};
+
+#endif
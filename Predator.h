@@ -10,6 +10,8 @@ public:
 
     bool IsPrey() const override { return false; }
 
+    Species GetSpecies() const override { return Species::Predator; }
+
     void SetAlpha(double new_alpha) override {
         alpha = new_alpha;
     }
@@ -10,6 +10,8 @@ public:
 
     bool IsPrey() const override { return true; }
 
+    Species GetSpecies() const override { return Species::Prey2; }
+
     void SetAlpha(double new_alpha) override {
         alpha = new_alpha;
     }
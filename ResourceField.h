@@ -0,0 +1,160 @@
+#ifndef RESOURCE_FIELD_H
+#define RESOURCE_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// Rates of the dynamic environment phase (World::EnableEnvironment), all per
+// generation.
+struct EnvironmentParams {
+    float consumption = 0.1f;    // Resource eaten by a patch's prey occupant, at most what is there
+    float regrowth = 0.05f;      // Logistic growth rate towards the patch's capacity
+    float diffusion = 0.05f;     // Fraction of the difference to the mean of the 4 neighbors that flows in
+    float danger_deposit = 1.0f; // Danger a predator lays down on its patch
+    float danger_decay = 0.1f;   // Fraction of the danger that fades
+};
+
+// One step of the resource and danger fields over row-major flat arrays.
+// Every patch exchanges resource with its four grid neighbors (zero flux
+// across bounded edges, wrapping on a torus), loses what its prey eat and
+// regrows logistically towards its capacity; a capacity of 0 lets the
+// patch run dry. Danger decays and is topped up by the patch's predators.
+// The new zone of every patch is written alongside, so callers can
+// reclassify only the patches that crossed a threshold.
+//
+// Rows are processed in column blocks so the three input rows of a block
+// stay in L1 between rows. Interior cells are a branch-free loop over
+// plain arrays, which compilers turn into AVX2/AVX-512 or SIMD128 code;
+// the first and last column are done separately. Each cell depends only on
+// the inputs, so any split of rows between threads gives the same result.
+class ResourceField {
+private:
+    static constexpr size_t block_columns = 1024;
+
+    EnvironmentParams params;
+    float low_zone_min_float;    // Smallest float level in zone 1 or above
+    float medium_zone_min_float; // Smallest float level in zone 2
+
+    // The smallest float f with f >= threshold as doubles, so float
+    // comparisons classify exactly like World::ClassifyZone.
+    static float FloatThreshold(double threshold) {
+        float f = static_cast<float>(threshold);
+        if (static_cast<double>(f) < threshold) f = std::nextafter(f, std::numeric_limits<float>::infinity());
+        return f;
+    }
+
+    // Takes the rates as a local copy, which cannot alias the output rows,
+    // so the compiler keeps them in registers.
+    static float NextResource(const EnvironmentParams& p, float center, float neighbor_sum, float capacity,
+                              uint8_t prey) {
+        float r = center + p.diffusion * (0.25f * neighbor_sum - center);
+        r -= std::min(r, p.consumption * static_cast<float>(prey));
+        // Both branches are computed, so the loop stays branch-free.
+        float logistic = p.regrowth * r * (1.0f - r / std::max(capacity, std::numeric_limits<float>::min()));
+        float growth = capacity > 0.0f ? logistic : -r;
+        return std::max(0.0f, r + growth);
+    }
+
+    static int8_t ZoneOf(float r, float low_min, float medium_min) {
+        return static_cast<int8_t>((r >= low_min) + (r >= medium_min));
+    }
+
+    // Cells [first, last) of a row, none of them on the first or last
+    // column. The outputs never overlap the inputs; saying so with
+    // __restrict spares the vectorizer a dozen run-time overlap checks.
+    static void InteriorCells(const EnvironmentParams& p, float low_min, float medium_min, size_t first, size_t last,
+                              const float* __restrict row, const float* __restrict up,
+                              const float* __restrict down, const float* __restrict capacity,
+                              const uint8_t* __restrict prey, const uint8_t* __restrict predators,
+                              float* __restrict danger, float* __restrict out, int8_t* __restrict zone) {
+        const float keep = 1.0f - p.danger_decay;
+        const float deposit = p.danger_deposit;
+        for (size_t x = first; x < last; ++x) {
+            out[x] = NextResource(p, row[x], up[x] + down[x] + row[x - 1] + row[x + 1], capacity[x], prey[x]);
+            zone[x] = ZoneOf(out[x], low_min, medium_min);
+            danger[x] = danger[x] * keep + deposit * static_cast<float>(predators[x]);
+        }
+    }
+
+public:
+    // Inputs of one step; resource_out and zone_out receive the results and
+    // danger is updated in place.
+    struct Arrays {
+        const float* resource;
+        const float* capacity;
+        const uint8_t* prey;
+        const uint8_t* predators;
+        float* danger;
+        float* resource_out;
+        int8_t* zone_out;
+    };
+
+    ResourceField(const EnvironmentParams& environment, double low_max, double medium_max)
+        : params(environment), low_zone_min_float(FloatThreshold(low_max)),
+          medium_zone_min_float(FloatThreshold(medium_max)) {}
+
+    // Advances rows [row_begin, row_end) of a width x height grid.
+    void StepRows(const Arrays& a, size_t width, size_t height, bool torus, size_t row_begin, size_t row_end) const {
+        const EnvironmentParams p = params;
+        const float low_min = low_zone_min_float;
+        const float medium_min = medium_zone_min_float;
+        const float keep = 1.0f - p.danger_decay;
+        const float deposit = p.danger_deposit;
+        for (size_t block = 0; block < width; block += block_columns) {
+            size_t block_end = std::min(width, block + block_columns);
+            size_t first = std::max<size_t>(block, 1);
+            size_t last = std::min(block_end, width - 1);
+            for (size_t y = row_begin; y < row_end; ++y) {
+                size_t up_row = y > 0 ? y - 1 : (torus ? height - 1 : y);
+                size_t down_row = y + 1 < height ? y + 1 : (torus ? 0 : y);
+                const float* row = a.resource + y * width;
+                const float* up = a.resource + up_row * width;
+                const float* down = a.resource + down_row * width;
+                const float* capacity = a.capacity + y * width;
+                const uint8_t* prey = a.prey + y * width;
+                const uint8_t* predators = a.predators + y * width;
+                float* danger = a.danger + y * width;
+                float* out = a.resource_out + y * width;
+                int8_t* zone = a.zone_out + y * width;
+
+                auto edge_cell = [&](size_t x) {
+                    size_t left = x > 0 ? x - 1 : (torus ? width - 1 : x);
+                    size_t right = x + 1 < width ? x + 1 : (torus ? 0 : x);
+                    out[x] = NextResource(p, row[x], up[x] + down[x] + row[left] + row[right], capacity[x], prey[x]);
+                    zone[x] = ZoneOf(out[x], low_min, medium_min);
+                    danger[x] = danger[x] * keep + deposit * static_cast<float>(predators[x]);
+                };
+
+                if (block == 0) edge_cell(0);
+                InteriorCells(p, low_min, medium_min, first, last, row, up, down, capacity, prey, predators, danger,
+                              out, zone);
+                if (block_end == width && width > 1) edge_cell(width - 1);
+            }
+        }
+    }
+
+    // Calls f(j) for every j where old_zone and new_zone differ, comparing
+    // eight patches at a time.
+    template <typename F>
+    static void ForEachChangedZone(const int8_t* old_zone, const int8_t* new_zone, size_t count, F&& f) {
+        size_t j = 0;
+        for (; j + 8 <= count; j += 8) {
+            uint64_t before, after;
+            std::memcpy(&before, old_zone + j, 8);
+            std::memcpy(&after, new_zone + j, 8);
+            if (before == after) continue;
+            for (size_t k = j; k < j + 8; ++k) {
+                if (old_zone[k] != new_zone[k]) f(k);
+            }
+        }
+        for (; j < count; ++j) {
+            if (old_zone[j] != new_zone[j]) f(j);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef SKIP_SAMPLING_H
+#define SKIP_SAMPLING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+// Exact shortcuts for runs of Bernoulli trials, usable with any RNG that
+// provides GetDouble and P. Each gives the same distribution as drawing
+// the trials one by one, with far fewer draws when events are rare.
+
+// Number of failures before the next success in Bernoulli(p) trials
+// (a geometric variate), from one uniform by inversion.
+template <typename RNG>
+uint64_t GeometricSkip(RNG& rng, double p) {
+    if (p >= 1.0) return 0;
+    if (p <= 0.0) return std::numeric_limits<uint64_t>::max();
+    double u = 1.0 - rng.GetDouble(); // (0, 1], keeps log finite.
+    double skip = std::floor(std::log(u) / std::log1p(-p));
+    if (skip >= 1.8e19) return std::numeric_limits<uint64_t>::max();
+    return static_cast<uint64_t>(skip);
+}
+
+// min(Binomial(n, p), cap) from one uniform by inversion of the CDF,
+// which is cheap for the small n of a litter.
+template <typename RNG>
+size_t CappedBinomial(RNG& rng, int n, double p, size_t cap) {
+    size_t limit = std::min(static_cast<size_t>(std::max(n, 0)), cap);
+    if (limit == 0 || p <= 0.0) return 0;
+    if (p >= 1.0) return limit;
+    double u = rng.GetDouble();
+    double odds = p / (1.0 - p);
+    double pmf = std::pow(1.0 - p, n);
+    double cdf = pmf;
+    size_t k = 0;
+    while (k < limit && u >= cdf) {
+        pmf *= odds * static_cast<double>(n - static_cast<int>(k)) / static_cast<double>(k + 1);
+        cdf += pmf;
+        ++k;
+    }
+    return k;
+}
+
+// A run of Bernoulli(p) trials answered one at a time. With skipping on,
+// a geometric skip is drawn once per success instead of one uniform per
+// trial; otherwise every trial is a plain P(p) draw.
+class BernoulliTrials {
+private:
+    double p;
+    bool skip;
+    bool primed = false;
+    uint64_t failures_left = 0;
+
+public:
+    BernoulliTrials(double probability, bool use_skip) : p(probability), skip(use_skip) {}
+
+    template <typename RNG>
+    bool Next(RNG& rng) {
+        if (!skip) return rng.P(p);
+        if (!primed) {
+            failures_left = GeometricSkip(rng, p);
+            primed = true;
+        }
+        if (failures_left == 0) {
+            primed = false;
+            return true;
+        }
+        --failures_left;
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef STEP_PROFILE_H
+#define STEP_PROFILE_H
+
+#include <chrono>
+#include <cstdint>
+
+// Step profiling is compiled in only with -DWORLD_PROFILE. Without it the
+// timers and counters below do nothing and World::GetStepProfile stays zero.
+#ifdef WORLD_PROFILE
+constexpr bool step_profiling = true;
+#else
+constexpr bool step_profiling = false;
+#endif
+
+// Event counts for one generation. A move is attempted when an organism's
+// move trial succeeds, and blocked when its destination was already
+// occupied or claimed. Offspring are generated by successful birth trials
+// and discarded when they lose their target to another parent (parallel
+// steps only; the sequential step stops trials once a parent has no free
+// target). Every P, GetDouble, GetUInt or GetRandNormal call is one draw.
+// Zone changes count patches reclassified by the environment phase. A
+// hunt is a predator with prey next to it trying for a catch; captures
+// count the prey caught.
+struct StepCounters {
+    uint64_t moves_attempted = 0;
+    uint64_t moves_blocked = 0;
+    uint64_t offspring_generated = 0;
+    uint64_t offspring_discarded = 0;
+    uint64_t deaths = 0;
+    uint64_t rng_draws = 0;
+    uint64_t zone_changes = 0;
+    uint64_t hunts = 0;
+    uint64_t captures = 0;
+
+    void Merge(const StepCounters& other) {
+        moves_attempted += other.moves_attempted;
+        moves_blocked += other.moves_blocked;
+        offspring_generated += other.offspring_generated;
+        offspring_discarded += other.offspring_discarded;
+        deaths += other.deaths;
+        rng_draws += other.rng_draws;
+        zone_changes += other.zone_changes;
+        hunts += other.hunts;
+        captures += other.captures;
+    }
+};
+
+// Wall time of each Step phase, in seconds, and the generation's counters.
+struct StepProfile {
+    double move_seconds = 0.0;
+    double predation_seconds = 0.0;
+    double reproduce_seconds = 0.0;
+    double cull_seconds = 0.0;
+    double environment_seconds = 0.0;
+    StepCounters counters;
+};
+
+#ifdef WORLD_PROFILE
+// Adds the time until it goes out of scope to total.
+class PhaseTimer {
+private:
+    double& total;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit PhaseTimer(double& phase_total) : total(phase_total), start(std::chrono::steady_clock::now()) {}
+    ~PhaseTimer() { total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); }
+};
+
+// Forwards to an RNG, counting every draw.
+template <typename RNG>
+class CountedRandom {
+private:
+    RNG& rng;
+    uint64_t& draws;
+
+public:
+    CountedRandom(RNG& source, uint64_t& draw_count) : rng(source), draws(draw_count) {}
+
+    bool P(double p) { ++draws; return rng.P(p); }
+    double GetDouble() { ++draws; return rng.GetDouble(); }
+    template <typename T>
+    auto GetUInt(T max) { ++draws; return rng.GetUInt(max); }
+    double GetRandNormal(double mean, double sd) { ++draws; return rng.GetRandNormal(mean, sd); }
+};
+
+template <typename RNG>
+CountedRandom<RNG> Counted(RNG& rng, uint64_t& draws) { return CountedRandom<RNG>(rng, draws); }
+#else
+class PhaseTimer {
+public:
+    explicit PhaseTimer(double&) {}
+};
+
+template <typename RNG>
+RNG& Counted(RNG& rng, uint64_t&) { return rng; }
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+
+// Persistent worker threads with work stealing. Each worker owns a task
+// queue: it takes its newest task first and, when its queue is empty,
+// steals the oldest task from another queue, so uneven tasks (such as
+// simulation runs of different lengths) keep every thread busy.
+//
+// The calling thread counts as one of the pool's threads: ParallelFor and
+// Wait run tasks on it too, so a pool of size 1 runs everything inline.
+class ThreadPool {
+private:
+    using Task = std::function<void()>;
+
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::atomic<size_t> next_queue{0};
+    std::atomic<size_t> queued_tasks{0};
+    size_t unfinished_tasks = 0;
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    bool stopping = false;
+
+    // Pops from queue `home` (newest first), else steals from the others
+    // (oldest first).
+    bool TryPop(size_t home, Task& task) {
+        for (size_t k = 0; k < queues.size(); ++k) {
+            TaskQueue& queue = *queues[(home + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+            if (k == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            queued_tasks--;
+            return true;
+        }
+        return false;
+    }
+
+    void RunTask(Task& task) {
+        task();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--unfinished_tasks == 0) work_done.notify_all();
+    }
+
+    void WorkerLoop(size_t home) {
+        Task task;
+        while (true) {
+            if (TryPop(home, task)) {
+                RunTask(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            work_ready.wait(lock, [&] { return stopping || queued_tasks > 0; });
+            if (stopping && queued_tasks == 0) return;
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t num_threads) {
+        size_t num_workers = num_threads > 1 ? num_threads - 1 : 0;
+        for (size_t i = 0; i < std::max<size_t>(num_workers, 1); ++i) {
+            queues.push_back(std::make_unique<TaskQueue>());
+        }
+        for (size_t i = 0; i < num_workers; ++i) {
+            workers.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        Wait();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work_ready.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    size_t Size() const { return workers.size() + 1; }
+
+    // Queues a task. Tasks are spread round-robin over the worker queues.
+    void Submit(Task task) {
+        SubmitTo(next_queue++, std::move(task));
+    }
+
+    // Queues a task on worker (home % worker count)'s own queue, where that
+    // worker looks first.
+    void SubmitTo(size_t home, Task task) {
+        // Counted before it becomes visible, so a thief can never finish it
+        // before it is counted.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued_tasks++;
+            unfinished_tasks++;
+        }
+        TaskQueue& queue = *queues[home % queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        work_ready.notify_one();
+    }
+
+    // Runs queued tasks on the calling thread too, and returns once every
+    // submitted task has finished.
+    void Wait() {
+        Task task;
+        while (TryPop(0, task)) RunTask(task);
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [&] { return unfinished_tasks == 0; });
+    }
+
+    // Calls func(begin, end) on disjoint blocks covering [0, n) and returns
+    // once every block is done. Block boundaries depend only on n and grain,
+    // never on timing.
+    template <typename Func>
+    void ParallelFor(size_t n, Func&& func, size_t grain = 256) {
+        if (n == 0) return;
+        if (workers.empty() || n <= grain) {
+            for (size_t begin = 0; begin < n; begin += grain) func(begin, std::min(n, begin + grain));
+            return;
+        }
+
+        std::atomic<size_t> next_block{0};
+        auto run_blocks = [&] {
+            size_t begin;
+            while ((begin = next_block.fetch_add(grain)) < n) {
+                func(begin, std::min(n, begin + grain));
+            }
+        };
+
+        // One helper task per worker; the caller takes blocks as well.
+        std::atomic<size_t> helpers_left{workers.size()};
+        for (size_t i = 0; i < workers.size(); ++i) {
+            Submit([&] {
+                run_blocks();
+                if (helpers_left.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    work_done.notify_all();
+                }
+            });
+        }
+        run_blocks();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [&] { return helpers_left == 0; });
+    }
+
+    // Calls func(slot) once for every slot in [0, Size()) and returns once
+    // all are done: slot 0 on the caller, slot k on worker k - 1's queue.
+    // For static schedules in which every thread keeps the same share of
+    // the work from call to call. An idle worker may still steal a slot, so
+    // results must depend only on the slot number, never on the thread.
+    template <typename Func>
+    void RunSlots(Func&& func) {
+        if (workers.empty()) {
+            func(size_t{0});
+            return;
+        }
+        std::atomic<size_t> helpers_left{workers.size()};
+        for (size_t i = 0; i < workers.size(); ++i) {
+            SubmitTo(i, [&, i] {
+                func(i + 1);
+                if (helpers_left.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    work_done.notify_all();
+                }
+            });
+        }
+        func(size_t{0});
+
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [&] { return helpers_left == 0; });
+    }
+};
+
+#endif
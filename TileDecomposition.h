@@ -0,0 +1,145 @@
+#ifndef TILE_DECOMPOSITION_H
+#define TILE_DECOMPOSITION_H
+
+#include "GridTopology.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// Splits a grid into fixed-size rectangular tiles (the last row and column
+// of tiles may be smaller) and deals them to the slots of a ThreadPool for
+// tiled parallel steps. Each step phase buckets the organisms by tile, then
+// gives every slot a run of consecutive tiles holding about the same number
+// of organisms. A slot owns the patches of its tiles: only it writes their
+// claims. Claims on another slot's patches go into an outbox for that slot,
+// and each slot drains the outboxes addressed to it after a barrier, so the
+// exchange happens once per phase with no locks or atomics.
+//
+// Tiles are numbered row by row, and within a tile organisms keep their
+// dense order, so the buckets depend only on the grid and the organisms,
+// never on the thread count. Which slot owns a tile is recomputed every
+// phase from the organism counts, so ownership shifts as populations move;
+// tiling improves locality within a phase, not across steps.
+class TileDecomposition {
+public:
+    // A claim on patch `patch` by the organism at dense index `claimant`.
+    struct Claim {
+        uint32_t patch;
+        uint32_t claimant;
+    };
+
+private:
+    size_t tile_width = 0;
+    size_t tile_height = 0;
+    size_t num_tiles = 0;
+    std::vector<uint32_t> patch_tile;   // Tile of every patch.
+    std::vector<uint32_t> tile_start;   // members[tile_start[t], tile_start[t + 1]) are tile t's organisms.
+    std::vector<uint32_t> members;      // Dense indices, grouped by tile.
+    std::vector<uint32_t> slot_counts;  // Per slot and tile, counts and then scatter offsets.
+    std::vector<size_t> slot_first_tile; // Slot s owns tiles [slot_first_tile[s], slot_first_tile[s + 1]).
+    std::vector<uint32_t> tile_slot;    // Owner slot of every tile.
+    std::vector<std::vector<Claim>> outboxes; // outboxes[from * slots + to].
+    size_t num_slots = 0;
+
+public:
+    bool IsEnabled() const { return num_tiles > 0; }
+    size_t TileWidth() const { return tile_width; }
+    size_t TileHeight() const { return tile_height; }
+    size_t TileCount() const { return num_tiles; }
+
+    // Cuts grid into width x height tiles; 0 for either turns tiling off.
+    void Assign(const GridTopology& grid, size_t width, size_t height) {
+        tile_width = width;
+        tile_height = height;
+        num_tiles = 0;
+        patch_tile.clear();
+        if (width == 0 || height == 0 || grid.Width() == 0) return;
+        size_t tiles_x = (grid.Width() + width - 1) / width;
+        size_t tiles_y = (grid.Height() + height - 1) / height;
+        num_tiles = tiles_x * tiles_y;
+        patch_tile.resize(grid.Width() * grid.Height());
+        for (size_t i = 0; i < patch_tile.size(); ++i) {
+            patch_tile[i] = static_cast<uint32_t>((grid.Y(i) / height) * tiles_x + grid.X(i) / width);
+        }
+    }
+
+    // Buckets organisms [0, n) by the tile of patch_of(d), in parallel over
+    // the pool's slots, and splits the tiles between the slots.
+    template <typename PatchOf>
+    void Bucket(ThreadPool& pool, size_t n, PatchOf&& patch_of) {
+        num_slots = pool.Size();
+        members.resize(n);
+        slot_counts.assign(num_slots * num_tiles, 0);
+        auto first_organism = [&](size_t s) { return n * s / num_slots; };
+
+        pool.RunSlots([&](size_t s) {
+            uint32_t* counts = &slot_counts[s * num_tiles];
+            for (size_t d = first_organism(s); d < first_organism(s + 1); ++d) counts[patch_tile[patch_of(d)]]++;
+        });
+
+        // Slot s's organisms of tile t go after those of slots before s.
+        tile_start.assign(num_tiles + 1, 0);
+        uint32_t running = 0;
+        for (size_t t = 0; t < num_tiles; ++t) {
+            tile_start[t] = running;
+            for (size_t s = 0; s < num_slots; ++s) {
+                uint32_t count = slot_counts[s * num_tiles + t];
+                slot_counts[s * num_tiles + t] = running;
+                running += count;
+            }
+        }
+        tile_start[num_tiles] = running;
+
+        pool.RunSlots([&](size_t s) {
+            uint32_t* next = &slot_counts[s * num_tiles];
+            for (size_t d = first_organism(s); d < first_organism(s + 1); ++d) {
+                members[next[patch_tile[patch_of(d)]]++] = static_cast<uint32_t>(d);
+            }
+        });
+
+        // Consecutive tiles per slot, balanced on organisms plus one per
+        // tile for the fixed cost of visiting it.
+        slot_first_tile.assign(num_slots + 1, num_tiles);
+        tile_slot.resize(num_tiles);
+        double total = static_cast<double>(n + num_tiles);
+        size_t s = 0;
+        slot_first_tile[0] = 0;
+        for (size_t t = 0; t < num_tiles; ++t) {
+            double done = static_cast<double>(tile_start[t] + t);
+            while (s + 1 < num_slots && done >= total * (s + 1) / num_slots) slot_first_tile[++s] = t;
+            tile_slot[t] = static_cast<uint32_t>(s);
+        }
+
+        outboxes.resize(num_slots * num_slots);
+        for (auto& outbox : outboxes) outbox.clear();
+    }
+
+    size_t FirstTile(size_t slot) const { return slot_first_tile[slot]; }
+    size_t EndTile(size_t slot) const { return slot_first_tile[slot + 1]; }
+
+    // Organisms of tile t, in dense order.
+    const uint32_t* TileBegin(size_t t) const { return members.data() + tile_start[t]; }
+    const uint32_t* TileEnd(size_t t) const { return members.data() + tile_start[t + 1]; }
+
+    size_t OwnerOf(size_t patch_index) const { return tile_slot[patch_tile[patch_index]]; }
+
+    void Send(size_t from_slot, size_t to_slot, size_t patch_index, size_t claimant) {
+        outboxes[from_slot * num_slots + to_slot].push_back(
+            {static_cast<uint32_t>(patch_index), static_cast<uint32_t>(claimant)});
+    }
+
+    // Calls f(claim) for every claim sent to slot `to_slot`, then empties
+    // those outboxes.
+    template <typename F>
+    void Receive(size_t to_slot, F&& f) {
+        for (size_t from = 0; from < num_slots; ++from) {
+            auto& outbox = outboxes[from * num_slots + to_slot];
+            for (const Claim& claim : outbox) f(claim);
+            outbox.clear();
+        }
+    }
+};
+
+#endif
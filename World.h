@@ -2,6 +2,21 @@
 #define WORLD_H
 
 #include "Organism.h"
+#include "OrganismStore.h"
+#include "OccupancyBitmap.h"
+#include "FenwickTree.h"
+#include "PatchScoreKernel.h"
+#include "CounterRandom.h"
+#include "BatchRandom.h"
+#include "SkipSampling.h"
+#include "PopulationCensus.h"
+#include "ThreadPool.h"
+#include "Checkpoint.h"
+#include "StepProfile.h"
+#include "WorldPolicy.h"
+#include "GridTopology.h"
+#include "TileDecomposition.h"
+#include "ResourceField.h"
 #include "emp/math/Random.hpp"
 #include <vector>
 #include <numeric>
@@ -10,36 +25,570 @@
 #include <functional>
 #include <cmath>
 #include <random> 
+#include <array>
+#include <tuple>
+#include <limits>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <fstream>
+#include <string>
 
-// NEW INCLUDES: Required for ResetOrganisms to know about these types
+// Concrete organism types, for callers building organisms to pass to AddOrganism
 #include "Prey.h"
 #include "Prey2.h"
 #include "Predator.h"
 
-struct Patch {
-    std::vector<Organism*> occupants;
-    double resource_level = 1.0;
-    double danger_level = 0.0;
+// Where offspring may be placed. ParentPatch is the original rule: an
+// offspring needs its parent's patch to be empty, which never happens
+// while the parent occupies it. AdjacentPatch allows the empty patches
+// to the left and right of the parent's patch on the grid, (x - 1, y) and
+// (x + 1, y), or, with a local neighborhood (World::SetNeighborhood), the
+// empty patches of the parent's neighborhood.
+// NearestFreePatch places each offspring in the free patch closest to its
+// parent in index order.
+enum class OffspringPlacement { ParentPatch, AdjacentPatch, NearestFreePatch };
+
+// Rates of the predation phase (World::EnablePredation).
+struct PredationParams {
+    double capture_probability = 0.5; // Chance a predator catches the prey it goes for
+    double conversion = 1.0;          // Chance each catch turns into an offspring
 };
 
-class World {
+// The simulation, specialized at compile time by a policy (WorldPolicy.h)
+// giving the zone thresholds, predator movement weights and offspring
+// species rule. World, defined below, is the runtime-configurable default;
+// a fixed policy such as TauSplitWorldPolicy lets the compiler inline the
+// species rule into Reproduce instead of calling a std::function.
+template <typename Policy = DefaultWorldPolicy>
+class BasicWorld {
 private:
-    std::vector<Patch> patches;
+    // Patch state is kept as parallel arrays indexed by patch, about 11 bytes
+    // per patch in total (resource 4, occupant 4, zone 1, census counts 2,
+    // occupancy bit), so even 10^8-patch worlds fit comfortably in memory.
+    // The dynamic environment adds about 13 more while it is on.
+    static constexpr uint32_t no_occupant = UINT32_MAX;
+    std::vector<float> patch_resource;
+    std::vector<int8_t> patch_zone;        // ClassifyZone(patch_resource), kept current.
+    std::vector<uint32_t> patch_occupant;  // Store slot of the occupant, or no_occupant.
+
+    OrganismStore organisms;
+    // One bit per patch, set while the patch has an occupant.
+    OccupancyBitmap occupancy;
+    // random and batch_random restart at every Step from the seed and
+    // generation (ReseedSequential), so a step boundary needs no saved state.
     emp::Random random; 
     std::mt19937 std_random; 
+    // Buffered bulk generator that replaces random in the sequential step
+    // when batched_random is set (SetBatchedRandom).
+    BatchRandom batch_random;
+    bool batched_random = false;
     double mutation_rate = 0.05;
     double mutation_sd = 0.025;
     double predator_death_rate = 0.00001;
-    std::function<Organism*(bool, double, double, double)> clone_func;
+    typename Policy::SpeciesRule species_rule;
+    OffspringPlacement offspring_placement = OffspringPlacement::ParentPatch;
+
+    // Census: prey/predator counts per patch, and per-group, per-zone
+    // counts and trait sums. Kept in step with every placement, move, birth
+    // and death so that movement scoring and statistics never rescan.
+    std::vector<uint8_t> patch_prey_count;
+    std::vector<uint8_t> patch_predator_count;
+    PopulationCensus census;
+
+    // Predator destination tables, rebuilt lazily once per MoveOrganisms.
+    std::array<std::vector<size_t>, 3> predator_zone_patches;
+    std::array<std::vector<double>, 3> predator_zone_cdf;
+    std::array<double, 3> predator_zone_total{};
+    std::array<bool, 3> predator_table_ready{};
+
+    // Indexed prey movement: a Fenwick tree over patch resource levels,
+    // used to propose prey destinations. Any change to resource levels
+    // (SetResourceLevel, checkpoint load, patch reordering, environment
+    // updates) marks it stale, and the next MoveOrganisms rebuilds it, so
+    // it always matches a fresh build exactly. Point updates would drift
+    // from one by rounding.
+    bool indexed_prey_movement = false;
+    FenwickTree resource_index;
+    bool resource_index_stale = true;
+    static constexpr int max_prey_proposals = 32;
+
+    // Grid geometry, patch storage order and movement neighborhood
+    // (SetGrid, SetPatchOrder, SetNeighborhood). A world starts as one row
+    // of patches in row-major order with global movement.
+    GridTopology grid;
+
+    // Skip sampling (SetSkipSampling): exact shortcuts for the per-organism
+    // Bernoulli trials. See SkipSampling.h.
+    bool skip_sampling = false;
+
+    // Parallel stepping (SetThreadCount). Each organism draws from its own
+    // CounterRandom stream keyed on (seed, generation, phase, patch), with
+    // the patch numbered row-major so the patch order does not matter, and
+    // contested patches go to the claimant with the smallest dense index via
+    // an atomic min on patch_claim, so the outcome never depends on how the
+    // work was split between threads.
+    uint64_t seed = 0;
+    uint64_t generation = 0;
+    std::unique_ptr<ThreadPool> thread_pool;
+    static constexpr uint32_t unclaimed = UINT32_MAX;
+    std::unique_ptr<std::atomic<uint32_t>[]> patch_claim;
+    static constexpr uint32_t move_stream = 0;
+    static constexpr uint32_t birth_stream = 1;
+    static constexpr uint32_t mutation_stream = 2;
+    static constexpr uint32_t death_stream = 3;
+    static constexpr uint32_t predation_stream = 4;
+    static constexpr size_t litter_grain = 256; // Parents per ParallelFor block in ReproduceParallel.
+
+    // Parallel reproduction scratch, kept between steps so a step only
+    // allocates when litters grow. Parent d's planned offspring are entries
+    // [litter_offset[d], litter_offset[d + 1]) of the litter arrays, sized
+    // from the prefix sum of the litters actually drawn. Targets are first
+    // planned into one buffer per ParallelFor block or tile slot.
+    std::vector<uint8_t> litter;
+    std::vector<uint32_t> litter_offset;
+    std::vector<size_t> litter_target;
+    std::vector<double> litter_alpha;
+    std::vector<double> litter_tau;
+    std::vector<std::vector<size_t>> planned_targets;
+
+    // Tiled parallel steps (SetTileSize): organisms are handled tile by
+    // tile, and each thread claims patches only in the tiles it owns.
+    TileDecomposition tiles;
+
+    // Dynamic environment (EnableEnvironment): capacity and danger per
+    // patch, and the next resource levels and zones computed by each
+    // update. Empty while the environment is off. Curve patch orders run
+    // the stencil on row-major copies (row_major_*).
+    bool environment_enabled = false;
+    EnvironmentParams environment;
+    std::vector<float> patch_capacity;
+    std::vector<float> patch_danger;
+    std::vector<float> next_resource;
+    std::vector<int8_t> next_zone;
+    std::vector<float> row_major_resource, row_major_capacity, row_major_danger;
+    std::vector<uint8_t> row_major_prey, row_major_predators;
+    double danger_total = 0.0; // Sum of patch_danger, for indexed prey movement.
+
+    // Predation (EnablePredation): prey caught by each predator in the last
+    // predation phase, by dense index, kept until Reproduce turns them into
+    // predator births. Empty when no predation phase preceded Reproduce.
+    bool predation_enabled = false;
+    PredationParams predation;
+    std::vector<uint8_t> predator_captures;
+    size_t last_captures = 0;
+
+    // Timings and counters of the current step (see StepProfile.h).
+    StepProfile profile;
+
+    // Adds to a profile counter; a no-op unless built with WORLD_PROFILE.
+    static void Count(uint64_t& counter, uint64_t amount = 1) {
+        if constexpr (step_profiling) counter += amount;
+    }
+
+    // Merges one parallel block's counters into the step's profile.
+    void MergeCounters(std::mutex& merge_mutex, const StepCounters& local) {
+        if constexpr (step_profiling) {
+            std::lock_guard<std::mutex> lock(merge_mutex);
+            profile.counters.Merge(local);
+        }
+    }
+
+    // Counts the organism at dense index d as standing on patch_index.
+    void CensusAdd(size_t d, size_t patch_index) {
+        bool is_prey = organisms.IsPrey(d);
+        if (is_prey) patch_prey_count[patch_index]++;
+        else patch_predator_count[patch_index]++;
+        census.Add(PopulationCensus::GroupOf(is_prey, organisms.GetTau(d)), patch_zone[patch_index],
+                   organisms.GetAlpha(d), organisms.GetTau(d));
+    }
+
+    void CensusRemove(size_t d, size_t patch_index) {
+        bool is_prey = organisms.IsPrey(d);
+        if (is_prey) patch_prey_count[patch_index]--;
+        else patch_predator_count[patch_index]--;
+        census.Remove(PopulationCensus::GroupOf(is_prey, organisms.GetTau(d)), patch_zone[patch_index],
+                      organisms.GetAlpha(d), organisms.GetTau(d));
+    }
+
+    // Adds an organism to the store and to its (empty) patch.
+    void Place(Species species, double a, double t, double m, int birth_zone, size_t patch_index) {
+        OrganismHandle h = organisms.Add(species, a, t, m, birth_zone, patch_index);
+        patch_occupant[patch_index] = h.slot;
+        occupancy.Set(patch_index);
+        CensusAdd(organisms.IndexOf(h), patch_index);
+    }
+
+    void Vacate(size_t patch_index) {
+        patch_occupant[patch_index] = no_occupant;
+        occupancy.Reset(patch_index);
+    }
+
+    // Removes the organism at dense index i from its patch and the store.
+    void RemoveOrganismAt(size_t i) {
+        size_t patch_index = organisms.GetPatch(i);
+        Vacate(patch_index);
+        CensusRemove(i, patch_index);
+        organisms.RemoveAt(i);
+    }
+
+    // Offspring species for the mutated traits, from the policy's rule.
+    Species OffspringSpecies(Species parent, double a, double t, double m) const {
+        return species_rule(parent, a, t, m);
+    }
+
+    struct Offspring {
+        Species species;
+        double a, t, m;
+        int zone;
+        size_t patch_index;
+    };
+
+    // emp::Random treats seeds <= 0 as "seed from the clock", so map any
+    // value into [1, 2^31 - 1].
+    static int EmpSeed(uint64_t value) { return static_cast<int>(1 + value % 0x7FFFFFFEull); }
+
+    // Restarts the sequential generators from the seed and the generation.
+    void ReseedSequential() {
+        uint64_t key = CounterRandom::Key(seed, generation);
+        random.ResetSeed(EmpSeed(key));
+        batch_random.Seed(key);
+    }
+
+    // Stream of the organism on patch_index, keyed on the patch's row-major
+    // index so that every patch order draws the same numbers.
+    CounterRandom StreamFor(uint32_t phase, size_t patch_index) const {
+        return CounterRandom(seed, generation, phase, grid.RowMajorIndex(patch_index));
+    }
+
+    // Lowers patch j's claim to d; the smallest claimant wins the patch.
+    void Claim(size_t j, uint32_t d) {
+        uint32_t current = patch_claim[j].load(std::memory_order_relaxed);
+        while (d < current && !patch_claim[j].compare_exchange_weak(current, d, std::memory_order_relaxed)) {}
+    }
+
+    // Danger a prey sees in patch j: its predators, plus the danger field
+    // while the environment is on.
+    double PreyDanger(size_t j) const {
+        double danger_val = static_cast<double>(patch_predator_count[j]);
+        if (environment_enabled) danger_val += patch_danger[j];
+        return danger_val;
+    }
+
+    // Sets patch j's zone, moving any occupant's census count with it.
+    void Reclassify(size_t j, int zone) {
+        bool occupied = occupancy.Test(j);
+        size_t d = occupied ? organisms.IndexOfSlot(patch_occupant[j]) : 0;
+        if (occupied) CensusRemove(d, j);
+        patch_zone[j] = static_cast<int8_t>(zone);
+        if (occupied) CensusAdd(d, j);
+    }
+
+    // Claim on a patch owned by the calling thread's tiles. No other thread
+    // writes it during the phase, so no compare-and-swap is needed.
+    void ClaimOwned(size_t j, uint32_t d) {
+        if (d < patch_claim[j].load(std::memory_order_relaxed)) patch_claim[j].store(d, std::memory_order_relaxed);
+    }
+
+    // Claims patch j for d from tile slot `slot`: directly if the slot owns
+    // j, otherwise through the owner's outbox.
+    void ClaimFromSlot(size_t slot, size_t j, size_t d) {
+        size_t owner = tiles.OwnerOf(j);
+        if (owner == slot) ClaimOwned(j, static_cast<uint32_t>(d));
+        else tiles.Send(slot, owner, j, d);
+    }
+
+    // Every slot applies the claims other slots sent to its tiles.
+    void ExchangeClaims() {
+        thread_pool->RunSlots([&](size_t s) {
+            tiles.Receive(s, [&](const TileDecomposition::Claim& claim) { ClaimOwned(claim.patch, claim.claimant); });
+        });
+    }
+
+    // Calls f(slot, d) for every organism d in [first, first + count), tile
+    // by tile, each slot visiting the tiles it owns.
+    template <typename F>
+    void ForEachOrganismByTile(size_t first, size_t count, F&& f) {
+        tiles.Bucket(*thread_pool, count, [&](size_t k) { return organisms.GetPatch(first + k); });
+        ForEachBucketedOrganism(first, f);
+    }
+
+    // Visits the organisms of the last ForEachOrganismByTile again, in the
+    // same order per slot.
+    template <typename F>
+    void ForEachBucketedOrganism(size_t first, F&& f) {
+        thread_pool->RunSlots([&](size_t s) {
+            for (size_t t = tiles.FirstTile(s); t < tiles.EndTile(s); ++t) {
+                for (const uint32_t* k = tiles.TileBegin(t); k != tiles.TileEnd(t); ++k) f(s, first + *k);
+            }
+        });
+    }
+
+    // Takes patch j for claimant d if d won it, resetting the claim. Called
+    // in increasing d, so later losers see the patch as unclaimed.
+    bool TakeClaim(size_t j, uint32_t d) {
+        if (patch_claim[j].load(std::memory_order_relaxed) != d) return false;
+        patch_claim[j].store(unclaimed, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Moves the organism at dense index d to an empty patch.
+    void Relocate(size_t d, size_t to) {
+        size_t from = organisms.GetPatch(d);
+        Vacate(from);
+        CensusRemove(d, from);
+        patch_occupant[to] = organisms.SlotAt(d);
+        occupancy.Set(to);
+        CensusAdd(d, to);
+        organisms.SetPatch(d, to);
+    }
+
+    // Birth trials for the organism at dense index d: the success chance per
+    // trial and the number of trials. False for predators outside their
+    // birth zone and, with predation on, for predators that caught nothing.
+    bool BirthTrials(size_t d, double& chance, int& max_babies) const {
+        size_t i = organisms.GetPatch(d);
+        double resources = patch_resource[i];
+        chance = 1.0;
+        max_babies = 1;
+        if (!organisms.IsPrey(d)) {
+            if (predation_enabled) {
+                // One trial per prey caught.
+                chance = predation.conversion;
+                max_babies = d < predator_captures.size() ? predator_captures[d] : 0;
+                if (max_babies == 0) return false;
+            }
+            return organisms.GetBirthZone(d) == patch_zone[i];
+        }
+        chance *= resources;
+        // Modified to make preys reproduce "so much faster"
+        // Litter size follows the patch's resource band, using the policy's
+        // zone thresholds: 4, 7 or 10 trials from low to high.
+        static constexpr int litter_by_zone[3] = {4, 7, 10}; // Significantly increased baby count
+        max_babies = litter_by_zone[ClassifyZone(resources)];
+        return true;
+    }
+
+    // Mutation trials, two per offspring, drawn from one BernoulliTrials run
+    // so that skip sampling can jump over the offspring that do not mutate.
+    BernoulliTrials MutationTrials() const { return BernoulliTrials(mutation_rate, skip_sampling); }
+
+    template <typename RNG>
+    void MutateTraits(RNG& rng, BernoulliTrials& trials, double& a, double& t) const {
+        if (trials.Next(rng)) a = std::clamp(a + rng.GetRandNormal(0, mutation_sd), 0.0, 1.0);
+        if (trials.Next(rng)) t = std::clamp(t + rng.GetRandNormal(0, mutation_sd), 0.0, 1.0);
+    }
+
+    // Successful birth trials, stopping once capacity is reached: one draw
+    // per trial, or a single capped binomial draw with skip sampling.
+    template <typename RNG>
+    size_t CountBirths(RNG& rng, double chance, int max_babies, size_t capacity) const {
+        if (skip_sampling) return CappedBinomial(rng, max_babies, chance, capacity);
+        size_t births = 0;
+        for (int b = 0; b < max_babies && births < capacity; ++b) {
+            if (rng.P(chance)) births++;
+        }
+        return births;
+    }
+
+    // Whether an organism with this move rate tries to move. With skip
+    // sampling, rates of 0 (Prey2) and 1 are decided without a draw.
+    template <typename RNG>
+    bool TriesToMove(RNG& rng, double move_rate) const {
+        if (skip_sampling && (move_rate <= 0.0 || move_rate >= 1.0)) return move_rate >= 1.0;
+        return rng.P(move_rate);
+    }
+
+    template <typename RNG>
+    size_t ChooseDestination(RNG& rng, size_t d) {
+        size_t i = organisms.GetPatch(d);
+        if (grid.IsLocal()) return ChooseLocalDestination(rng, d);
+        if (!organisms.IsPrey(d)) return ChoosePredatorDestination(rng, organisms.GetBirthZone(d), i);
+        if (indexed_prey_movement) return ChoosePreyDestinationIndexed(rng, organisms.GetAlpha(d), organisms.GetTau(d), i);
+        return ChoosePreyDestination(rng, organisms.GetAlpha(d), organisms.GetTau(d), i);
+    }
+
+    // The prey patch predator d goes for, found through the per-patch prey
+    // counts of the patches touching its own: a uniform pick among those
+    // holding prey, caught with the capture probability. Returns the patch
+    // count when there is no prey around or it escapes. Reads only shared
+    // state, so it is safe to call from parallel phases.
+    template <typename RNG>
+    size_t HuntTarget(RNG& rng, size_t d, StepCounters& counters) const {
+        size_t prey_patches[8];
+        size_t found = 0;
+        grid.ForEachAdjacent(organisms.GetPatch(d), [&](size_t j) {
+            if (patch_prey_count[j] > 0) prey_patches[found++] = j;
+        });
+        if (found == 0) return patch_resource.size();
+        Count(counters.hunts);
+        if (!rng.P(predation.capture_probability)) return patch_resource.size();
+        return prey_patches[found > 1 ? rng.GetUInt(found) : 0];
+    }
 
 public:
-    World(int num_patches) : patches(num_patches) {
+    BasicWorld(size_t num_patches)
+        : patch_resource(num_patches, 1.0f),
+          patch_zone(num_patches, static_cast<int8_t>(ClassifyZone(1.0))),
+          patch_occupant(num_patches, no_occupant),
+          occupancy(num_patches),
+          patch_prey_count(num_patches, 0),
+          patch_predator_count(num_patches, 0),
+          grid(num_patches, 1) {
         std::random_device rd; // Obtain a random number from hardware
         std_random.seed(rd()); // Seed the standard random engine
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+        batch_random.Seed(seed);
+    }
+
+    BasicWorld(size_t width, size_t height) : BasicWorld(width * height) {
+        SetGrid(width, height);
+    }
+
+    // Lays the patches out as a width x height grid, keeping the storage
+    // order and neighborhood. Patch indices are reinterpreted, not moved.
+    // Returns false, leaving the grid unchanged, if that is not the patch
+    // count.
+    bool SetGrid(size_t width, size_t height) {
+        if (width == 0 || width * height != patch_resource.size()) return false;
+        GridTopology resized(width, height, grid.Order());
+        resized.SetNeighborhood(grid.GetNeighborhood(), grid.Radius(), grid.Edges());
+        grid = resized;
+        tiles.Assign(grid, tiles.TileWidth(), tiles.TileHeight());
+        return true;
+    }
+
+    // Stores the patches in the given order (see GridTopology.h), moving
+    // patch state and organisms so every patch keeps its coordinates.
+    // Curve orders keep neighborhoods close in memory for local movement
+    // and placement. Patch indices, including those of organisms, change;
+    // use PatchIndex, PatchX and PatchY to go between indices and
+    // coordinates. Random streams are keyed on row-major indices, so with
+    // neighborhood movement and AdjacentPatch offspring, which visit
+    // patches by grid offset, a run follows the same trajectory in every
+    // order; rules that scan or search patches by index (global movement,
+    // NearestFreePatch) depend on it.
+    void SetPatchOrder(PatchOrder order) {
+        if (order == grid.Order()) return;
+        GridTopology reordered(grid.Width(), grid.Height(), order);
+        reordered.SetNeighborhood(grid.GetNeighborhood(), grid.Radius(), grid.Edges());
+        std::vector<uint32_t> new_index(patch_resource.size());
+        for (size_t i = 0; i < new_index.size(); ++i) {
+            new_index[i] = static_cast<uint32_t>(reordered.FromRowMajor(grid.RowMajorIndex(i)));
+        }
+        std::vector<float> resource(patch_resource.size());
+        std::vector<uint32_t> occupant(patch_occupant.size(), no_occupant);
+        for (size_t i = 0; i < new_index.size(); ++i) {
+            resource[new_index[i]] = patch_resource[i];
+            patch_zone[new_index[i]] = static_cast<int8_t>(ClassifyZone(resource[new_index[i]]));
+            occupant[new_index[i]] = patch_occupant[i];
+        }
+        patch_resource.swap(resource);
+        patch_occupant.swap(occupant);
+        resource_index_stale = true;
+        for (auto* field : {&patch_capacity, &patch_danger}) {
+            if (field->empty()) continue;
+            for (size_t i = 0; i < new_index.size(); ++i) resource[new_index[i]] = (*field)[i];
+            field->swap(resource);
+        }
+        occupancy.ClearAll();
+        for (size_t d = 0; d < organisms.Size(); ++d) {
+            size_t patch_index = new_index[organisms.GetPatch(d)];
+            organisms.SetPatch(d, patch_index);
+            occupancy.Set(patch_index);
+        }
+        RebuildCensus();
+        grid = reordered;
+        tiles.Assign(grid, tiles.TileWidth(), tiles.TileHeight());
     }
 
-    void SetCloneFunction(std::function<Organism*(bool, double, double, double)> func) {
-        clone_func = func;
+    PatchOrder GetPatchOrder() const { return grid.Order(); }
+
+    // Restricts movement and AdjacentPatch offspring placement to the
+    // patches within radius of an organism on the grid, so each mover
+    // costs O(radius^2) instead of O(patches). Global restores the
+    // whole-world rules.
+    void SetNeighborhood(Neighborhood neighborhood, int radius = 1, GridEdges edges = GridEdges::Bounded) {
+        grid.SetNeighborhood(neighborhood, radius, edges);
+    }
+
+    const GridTopology& GetGrid() const { return grid; }
+    size_t GetWidth() const { return grid.Width(); }
+    size_t GetHeight() const { return grid.Height(); }
+    size_t PatchIndex(size_t x, size_t y) const { return grid.Index(x, y); }
+    size_t PatchX(size_t patch_index) const { return grid.X(patch_index); }
+    size_t PatchY(size_t patch_index) const { return grid.Y(patch_index); }
+    // Index of a patch in row-major order, as used by outputs and checkpoints.
+    size_t RowMajorPatchIndex(size_t patch_index) const { return grid.RowMajorIndex(patch_index); }
+
+    // Seeds every random source the world uses, for reproducible runs.
+    void SetSeed(uint64_t new_seed) {
+        seed = new_seed;
+        random.ResetSeed(EmpSeed(new_seed));
+        batch_random.Seed(new_seed);
+        std_random.seed(static_cast<std::mt19937::result_type>(new_seed));
+    }
+
+    // Steps with num_threads threads (the caller counts as one). Any
+    // num_threads >= 1 gives bit-identical results for the same seed. 0, the
+    // default, keeps the original sequential step driven by emp::Random.
+    void SetThreadCount(size_t num_threads) {
+        if (num_threads == 0) {
+            thread_pool.reset();
+            return;
+        }
+        thread_pool = std::make_unique<ThreadPool>(num_threads);
+        if (!patch_claim) {
+            patch_claim = std::make_unique<std::atomic<uint32_t>[]>(patch_resource.size());
+            for (size_t j = 0; j < patch_resource.size(); ++j) patch_claim[j].store(unclaimed, std::memory_order_relaxed);
+        }
+    }
+
+    size_t GetThreadCount() const { return thread_pool ? thread_pool->Size() : 0; }
+
+    // Splits the grid into tile_width x tile_height tiles for parallel
+    // steps. Each thread then handles whole tiles, so its organisms and the
+    // patches they read are close together, and claims on patches in other
+    // threads' tiles are exchanged through outboxes once per phase (see
+    // TileDecomposition.h). Results are bit-identical to untiled parallel
+    // steps for any tile size and thread count. 0 turns tiling off; the
+    // sequential step ignores tiles.
+    void SetTileSize(size_t tile_width, size_t tile_height) {
+        tiles.Assign(grid, tile_width, tile_height);
+    }
+
+    size_t GetTileWidth() const { return tiles.TileWidth(); }
+    size_t GetTileHeight() const { return tiles.TileHeight(); }
+
+    // Makes the sequential step draw from BatchRandom's buffers instead of
+    // one emp::Random call per decision. Same distributions, different
+    // numbers. Parallel steps always use their CounterRandom streams.
+    void SetBatchedRandom(bool enabled) {
+        batched_random = enabled;
+    }
+
+    // Replaces per-organism Bernoulli draws with exact shortcuts: predator
+    // deaths and trait mutations jump straight to the next event with a
+    // geometric skip, a parent's litter size is one capped binomial draw,
+    // and move rates of 0 or 1 need no draw. Outcomes have the same
+    // distribution as the trial-by-trial step but come from different
+    // numbers.
+    void SetSkipSampling(bool enabled) {
+        skip_sampling = enabled;
+    }
+    uint64_t GetGeneration() const { return generation; }
+
+    // Phase timings and event counts of the last Step. Always zero unless
+    // built with -DWORLD_PROFILE.
+    static constexpr bool IsProfilingEnabled() { return step_profiling; }
+    const StepProfile& GetStepProfile() const { return profile; }
+
+    // Chooses the species an offspring is created as, from whether its
+    // parent is prey and its mutated alpha, tau and move rate. Only for
+    // policies with RuntimeSpeciesRule.
+    void SetOffspringSpeciesFunction(std::function<Species(bool, double, double, double)> func) {
+        species_rule.Set(func);
     }
 
     void SetPredatorDeathRate(double rate) {
@@ -54,270 +603,1082 @@ public:
         mutation_sd = sd;
     }
 
-    void AddOrganism(Organism* org, int patch_index) {
-        if (patches[patch_index].occupants.empty()) {
-            patches[patch_index].occupants.push_back(org);
-            org->SetBirthZone(ClassifyZone(patches[patch_index].resource_level));
-        } else {
-            delete org;
-        }
+    // Switches prey movement to O(log P) sampling. See ChoosePreyDestinationIndexed.
+    void SetIndexedPreyMovement(bool enabled) {
+        indexed_prey_movement = enabled;
+    }
+
+    void SetOffspringPlacement(OffspringPlacement placement) {
+        offspring_placement = placement;
+    }
+
+    // Turns on the predation phase between movement and reproduction (see
+    // Predation). Predators then breed only from what they catch: one birth
+    // trial per prey caught, succeeding with the conversion chance, and
+    // still only inside their birth zone. Births also need a placement rule
+    // other than ParentPatch (SetOffspringPlacement), since a parent's own
+    // patch is never free.
+    void EnablePredation(const PredationParams& params = PredationParams()) {
+        predation = params;
+        predation_enabled = true;
+    }
+
+    void DisablePredation() {
+        predation_enabled = false;
+        predator_captures.clear();
+        last_captures = 0;
+    }
+
+    bool IsPredationEnabled() const { return predation_enabled; }
+    const PredationParams& GetPredation() const { return predation; }
+    // Prey caught in the last predation phase.
+    size_t GetLastCaptureCount() const { return last_captures; }
+
+    // Adds an organism directly into the store if the patch is empty.
+    bool AddOrganism(Species species, double a, double t, double m, size_t patch_index) {
+        if (occupancy.Test(patch_index)) return false;
+        Place(species, a, t, m, patch_zone[patch_index], patch_index);
+        return true;
+    }
+
+    // Copies the organism's traits into the world if the patch is empty.
+    // The world takes ownership of org and deletes it either way.
+    void AddOrganism(Organism* org, size_t patch_index) {
+        AddOrganism(org->GetSpecies(), org->GetAlpha(), org->GetTau(), org->GetMoveRate(), patch_index);
+        delete org;
     }
 
     void Step() {
+        profile = StepProfile();
+        ReseedSequential();
         MoveOrganisms();
+        if (predation_enabled) Predation();
         Reproduce();
         CullDead();
+        if (environment_enabled) UpdateEnvironment();
+        generation++;
     }
 
-    int ClassifyZone(double r) {
-        if (r < 0.33) return 0;
-        if (r < 0.66) return 1;
+    static constexpr int ClassifyZone(double r) {
+        if (r < Policy::low_zone_max) return 0;
+        if (r < Policy::medium_zone_max) return 1;
         return 2;
     }
 
     void MoveOrganisms() {
-        std::vector<std::vector<Organism*>> new_occupants(patches.size());
+        PhaseTimer timer(profile.move_seconds);
+        predator_table_ready.fill(false);
+        if (indexed_prey_movement && !grid.IsLocal()) {
+            if (resource_index_stale) BuildResourceIndex();
+            if (environment_enabled) danger_total = std::accumulate(patch_danger.begin(), patch_danger.end(), 0.0);
+        }
+        if (thread_pool) {
+            MoveOrganismsParallel();
+            return;
+        }
+        if (batched_random) MoveOrganismsWith(batch_random);
+        else MoveOrganismsWith(random);
+    }
 
-        for (size_t i = 0; i < patches.size(); ++i) {
-            for (Organism* org : patches[i].occupants) {
-                if (!random.P(org->GetMoveRate())) {
-                    if (new_occupants[i].empty()) new_occupants[i].push_back(org);
-                    continue;
-                }
+    // Destinations are decided against the pre-move census and applied
+    // afterwards. Every organism keeps its own patch, and a mover may only
+    // take a patch that was empty at the start of the step and has not
+    // been claimed by an earlier mover; otherwise it stays put. This keeps
+    // every patch to at most one occupant.
+    template <typename RNG>
+    void MoveOrganismsWith(RNG& source) {
+        size_t n = organisms.Size();
+        std::vector<size_t> destination(n);
+        OccupancyBitmap claimed(patch_resource.size());
+        auto&& rng = Counted(source, profile.counters.rng_draws);
 
-                std::vector<double> patch_scores(patches.size());
-                for (size_t j = 0; j < patches.size(); ++j) {
-                    if (!org->IsPrey() &&
-                        org->GetBirthZone() != ClassifyZone(patches[j].resource_level)) {
-                        patch_scores[j] = 0;
-                        continue;
-                    }
+        for (size_t d = 0; d < n; ++d) {
+            size_t i = organisms.GetPatch(d);
+            destination[d] = i;
+            if (!TriesToMove(rng, organisms.GetMoveRate(d))) continue;
 
-                    double resource_val;
-                    double danger_val;
-
-                    if (org->IsPrey()) {
-                        int predators_in_patch = std::count_if(patches[j].occupants.begin(),
-                                                      patches[j].occupants.end(),
-                                                      [](Organism* o) { return !o->IsPrey(); });
-                        resource_val = patches[j].resource_level;
-                        danger_val = static_cast<double>(predators_in_patch);
-
-                        double a = org->GetAlpha();
-                        double t = org->GetTau();
-                        patch_scores[j] = a * (t * resource_val - (1 - t) * danger_val);
-                    } else {
-                        int predators_in_patch = std::count_if(patches[j].occupants.begin(),
-                                                      patches[j].occupants.end(),
-                                                      [](Organism* o) { return !o->IsPrey(); });
-                        int prey_count = patches[j].occupants.size() - predators_in_patch;
-                        resource_val = static_cast<double>(prey_count);
-                        danger_val = static_cast<double>(predators_in_patch);
-
-                        double a_predator_behavior = 0.5;
-                        double t_predator_behavior = 0.9;
-
-                        patch_scores[j] = a_predator_behavior * (t_predator_behavior * resource_val - (1 - t_predator_behavior) * danger_val);
-                    }
-                }
+            Count(profile.counters.moves_attempted);
+            size_t chosen_patch = ChooseDestination(rng, d);
+            if (!occupancy.Test(chosen_patch) && !claimed.Test(chosen_patch)) {
+                destination[d] = chosen_patch;
+                claimed.Set(chosen_patch);
+            } else {
+                Count(profile.counters.moves_blocked);
+            }
+        }
 
-                double total_score = std::accumulate(patch_scores.begin(), patch_scores.end(), 0.0);
-                size_t chosen_patch = i;
-                if (total_score > 0.0) {
-                    for (double& score : patch_scores) score /= total_score;
-                    double r_val = random.GetDouble();
-                    double running_total = 0.0;
-                    for (size_t k = 0; k < patch_scores.size(); ++k) {
-                        running_total += patch_scores[k];
-                        if (r_val <= running_total) {
-                            chosen_patch = k;
-                            break;
-                        }
-                    }
-                }
+        for (size_t d = 0; d < n; ++d) {
+            if (destination[d] != organisms.GetPatch(d)) Relocate(d, destination[d]);
+        }
+    }
 
-                if (new_occupants[chosen_patch].empty()) {
-                    new_occupants[chosen_patch].push_back(org);
-                } else {
-                    new_occupants[i].push_back(org);
+    // Same rule as the sequential MoveOrganisms: a mover wants an empty
+    // patch, and the earliest mover in dense order gets it. Destinations are
+    // chosen and claimed in parallel, then applied in order.
+    void MoveOrganismsParallel() {
+        // Tables are shared read-only by every thread, so build them up front.
+        if (organisms.Count(Species::Predator) > 0 && !grid.IsLocal()) {
+            for (int zone = 0; zone < 3; ++zone) BuildPredatorTable(zone);
+        }
+
+        size_t n = organisms.Size();
+        std::vector<size_t> destination(n);
+        std::mutex merge_mutex;
+        if (tiles.IsEnabled()) {
+            std::vector<StepCounters> slot_counters(thread_pool->Size());
+            ForEachOrganismByTile(0, n, [&](size_t s, size_t d) {
+                destination[d] = ParallelMoveTarget(d, slot_counters[s]);
+                if (destination[d] != organisms.GetPatch(d)) ClaimFromSlot(s, destination[d], d);
+            });
+            ExchangeClaims();
+            for (const StepCounters& local : slot_counters) MergeCounters(merge_mutex, local);
+        } else {
+            thread_pool->ParallelFor(n, [&](size_t begin, size_t end) {
+                StepCounters local;
+                for (size_t d = begin; d < end; ++d) {
+                    destination[d] = ParallelMoveTarget(d, local);
+                    if (destination[d] != organisms.GetPatch(d)) Claim(destination[d], static_cast<uint32_t>(d));
                 }
-            }
+                MergeCounters(merge_mutex, local);
+            });
         }
 
-        for (size_t i = 0; i < patches.size(); ++i) {
-            patches[i].occupants = std::move(new_occupants[i]);
+        for (size_t d = 0; d < n; ++d) {
+            size_t to = destination[d];
+            if (to == organisms.GetPatch(d)) continue;
+            if (TakeClaim(to, static_cast<uint32_t>(d))) Relocate(d, to);
+            else Count(profile.counters.moves_blocked);
         }
     }
 
-    void Reproduce() {
-        std::vector<std::pair<Organism*, int>> babies;
+    // The patch organism d wants this step: an empty patch it will claim,
+    // or its own patch. Draws from d's own stream, so any thread can ask.
+    size_t ParallelMoveTarget(size_t d, StepCounters& local) {
+        size_t i = organisms.GetPatch(d);
+        CounterRandom stream = StreamFor(move_stream, i);
+        auto&& rng = Counted(stream, local.rng_draws);
+        if (!TriesToMove(rng, organisms.GetMoveRate(d))) return i;
 
-        for (size_t i = 0; i < patches.size(); ++i) {
-            double resources = patches[i].resource_level;
-            int zone = ClassifyZone(resources);
+        Count(local.moves_attempted);
+        size_t chosen_patch = ChooseDestination(rng, d);
+        if (!occupancy.Test(chosen_patch)) return chosen_patch;
+        Count(local.moves_blocked);
+        return i;
+    }
 
-            for (Organism* org : patches[i].occupants) {
-                if (!org->IsPrey() && org->GetBirthZone() != zone) continue;
+    // Scores every patch for a prey with the vectorized full-scan kernel and
+    // samples a destination by roulette selection. Returns current_patch if
+    // the total score is not positive.
+    template <typename RNG>
+    size_t ChoosePreyDestination(RNG& rng, double a, double t, size_t current_patch) const {
+        PatchScoreKernel kernel(patch_resource.data(), patch_prey_count.data(),
+                                patch_predator_count.data(), patch_zone.data(), patch_resource.size());
+        kernel.SetPreyScoring(a, t, environment_enabled ? patch_danger.data() : nullptr);
 
-                double chance = 1.0;
+        double total_score = kernel.Total();
+        if (total_score <= 0.0) return current_patch;
 
-                if (org->IsPrey()) {
-                    chance *= resources;
-                    // Modified to make preys reproduce "so much faster"
-                    int max_babies = (resources >= 0.66) ? 10 : (resources >= 0.33 ? 7 : 4); // Significantly increased baby count
+        double r_val = rng.GetDouble();
+        size_t chosen_patch = kernel.Find(r_val * total_score);
+        return chosen_patch < patch_resource.size() ? chosen_patch : current_patch;
+    }
 
-                    for (int b = 0; b < max_babies; ++b) {
-                        if (random.P(chance)) {
-                            Organism* baby = org->Clone();
-                            baby->SetBirthZone(zone);
+    // The index behind indexed prey movement, rebuilt first if stale.
+    const FenwickTree& GetResourceIndex() {
+        if (resource_index_stale) BuildResourceIndex();
+        return resource_index;
+    }
 
-                            double a = baby->GetAlpha();
-                            double t = baby->GetTau();
-                            double m = baby->GetMoveRate();
-                            bool is_prey = baby->IsPrey();
+    void BuildResourceIndex() {
+        std::vector<double> weights(patch_resource.size());
+        for (size_t j = 0; j < patch_resource.size(); ++j) {
+            weights[j] = std::max(0.0f, patch_resource[j]);
+        }
+        resource_index.Assign(weights);
+        resource_index_stale = false;
+    }
 
-                            if (random.P(mutation_rate)) a = std::clamp(a + random.GetRandNormal(0, mutation_sd), 0.0, 1.0);
-                            if (random.P(mutation_rate)) t = std::clamp(t + random.GetRandNormal(0, mutation_sd), 0.0, 1.0);
+    // Indexed alternative to ChoosePreyDestination. The prey score
+    // a * (t * R_j - (1 - t) * D_j) is linear in resource and danger, so the
+    // summed score comes from the resource index total and the census
+    // predator total in O(1). As before, the prey stays put when that sum is
+    // not positive.
+    //
+    // Negative scores: destinations are drawn in proportion to max(0, score),
+    // so patches whose danger outweighs their resource are never chosen.
+    // (The linear scan instead lets negative scores shift the roulette
+    // boundaries of later patches.) Sampling is exact rejection: propose j in
+    // proportion to a * t * R_j, which bounds max(0, score_j), and accept
+    // with probability max(0, score_j) / (a * t * R_j). Patches without
+    // predators are always accepted. If every proposal is rejected, a linear
+    // draw from the same distribution is used instead.
+    template <typename RNG>
+    size_t ChoosePreyDestinationIndexed(RNG& rng, double a, double t, size_t current_patch) const {
+        double total_resource = resource_index.Total();
+        double total_danger = static_cast<double>(census.Count(CensusGroup::Predator));
+        if (environment_enabled) total_danger += danger_total;
+        if (a * (t * total_resource - (1 - t) * total_danger) <= 0.0) return current_patch;
 
-                            if (clone_func) {
-                                delete baby;
-                                baby = clone_func(is_prey, a, t, m);
-                                baby->SetBirthZone(zone);
-                            }
+        for (int attempt = 0; attempt < max_prey_proposals; ++attempt) {
+            size_t j = resource_index.Find(rng.GetDouble() * total_resource);
+            double resource_val = patch_resource[j];
+            if (resource_val <= 0.0) continue;
+            double danger_val = PreyDanger(j);
+            if (danger_val == 0.0) return j;
+            if (rng.P(1.0 - (1 - t) * danger_val / (t * resource_val))) return j;
+        }
 
-                            babies.emplace_back(baby, i);
-                        }
-                    }
-                } else {
-                    if (random.P(chance)) {
-                        Organism* baby = org->Clone();
-                        baby->SetBirthZone(zone);
+        std::vector<double> weights(patch_resource.size());
+        for (size_t j = 0; j < patch_resource.size(); ++j) {
+            weights[j] = std::max(0.0, a * (t * patch_resource[j] - (1 - t) * PreyDanger(j)));
+        }
+        double total_weight = std::accumulate(weights.begin(), weights.end(), 0.0);
+        if (total_weight <= 0.0) return current_patch;
+        double r_val = rng.GetDouble() * total_weight;
+        double running_total = 0.0;
+        for (size_t k = 0; k < weights.size(); ++k) {
+            running_total += weights[k];
+            if (r_val < running_total) return k;
+        }
+        return current_patch;
+    }
 
-                        double a = baby->GetAlpha();
-                        double t = baby->GetTau();
-                        double m = baby->GetMoveRate();
-                        bool is_prey = baby->IsPrey();
+    // Predator scores depend only on patch counts and on the birth zone, so
+    // one cumulative table per zone is shared by every predator this step.
+    // The table holds the running maximum of the normalized running total,
+    // which makes it monotone: its first entry >= r is exactly the first
+    // patch where the roulette running total reaches r, even when some
+    // scores are negative.
+    void BuildPredatorTable(int zone) {
+        constexpr double a_predator_behavior = Policy::predator_alpha;
+        constexpr double t_predator_behavior = Policy::predator_tau;
 
-                        if (random.P(mutation_rate)) a = std::clamp(a + random.GetRandNormal(0, mutation_sd), 0.0, 1.0);
-                        if (random.P(mutation_rate)) t = std::clamp(t + random.GetRandNormal(0, mutation_sd), 0.0, 1.0);
+        auto& zone_patches = predator_zone_patches[zone];
+        auto& cdf = predator_zone_cdf[zone];
+        zone_patches.clear();
+        cdf.clear();
 
-                        if (clone_func) {
-                            delete baby;
-                            baby = clone_func(is_prey, a, t, m);
-                            baby->SetBirthZone(zone);
-                        }
+        // Empty patches score exactly zero and cannot move the running
+        // total, so only occupied patches need to be visited.
+        std::vector<double> scores;
+        double total_score = 0.0;
+        occupancy.ForEachSet([&](size_t j) {
+            if (patch_zone[j] != zone) return;
+            double resource_val = static_cast<double>(patch_prey_count[j]);
+            double danger_val = static_cast<double>(patch_predator_count[j]);
+            double score = a_predator_behavior * (t_predator_behavior * resource_val - (1 - t_predator_behavior) * danger_val);
+            zone_patches.push_back(j);
+            scores.push_back(score);
+            total_score += score;
+        });
 
-                        babies.emplace_back(baby, i);
-                    }
-                }
+        predator_zone_total[zone] = total_score;
+        if (total_score > 0.0) {
+            double running_total = 0.0;
+            double running_max = -std::numeric_limits<double>::infinity();
+            for (double score : scores) {
+                running_total += score / total_score;
+                running_max = std::max(running_max, running_total);
+                cdf.push_back(running_max);
             }
         }
+        predator_table_ready[zone] = true;
+    }
 
-        for (auto& [baby, index] : babies) {
-            if (patches[index].occupants.empty()) {
-                patches[index].occupants.push_back(baby);
-            } else {
-                delete baby;
+    // Samples a predator destination from its birth zone's table in O(log P).
+    template <typename RNG>
+    size_t ChoosePredatorDestination(RNG& rng, int birth_zone, size_t current_patch) {
+        if (birth_zone < 0 || birth_zone > 2) return current_patch;
+        if (!predator_table_ready[birth_zone]) BuildPredatorTable(birth_zone);
+        if (predator_zone_total[birth_zone] <= 0.0) return current_patch;
+
+        const auto& cdf = predator_zone_cdf[birth_zone];
+        double r_val = rng.GetDouble();
+        auto it = std::lower_bound(cdf.begin(), cdf.end(), r_val);
+        if (it == cdf.end()) return current_patch;
+        return predator_zone_patches[birth_zone][it - cdf.begin()];
+    }
+
+    // Movement within the mover's neighborhood (its own patch included),
+    // by roulette selection over the same scores as the global rules: prey
+    // score resource against danger, predators score prey against danger in
+    // patches of their birth zone. Stays put if the summed score is not
+    // positive. O(radius^2) per mover and reads only shared state, so it is
+    // safe to call from parallel phases.
+    template <typename RNG>
+    size_t ChooseLocalDestination(RNG& rng, size_t d) const {
+        size_t i = organisms.GetPatch(d);
+        bool is_prey = organisms.IsPrey(d);
+        int birth_zone = organisms.GetBirthZone(d);
+        if (!is_prey && (birth_zone < 0 || birth_zone > 2)) return i;
+        double a = is_prey ? organisms.GetAlpha(d) : Policy::predator_alpha;
+        double t = is_prey ? organisms.GetTau(d) : Policy::predator_tau;
+
+        auto score = [&](size_t j) {
+            if (is_prey) return a * (t * patch_resource[j] - (1 - t) * PreyDanger(j));
+            if (patch_zone[j] != birth_zone) return 0.0;
+            double danger_val = static_cast<double>(patch_predator_count[j]);
+            return a * (t * static_cast<double>(patch_prey_count[j]) - (1 - t) * danger_val);
+        };
+
+        double total_score = 0.0;
+        grid.ForEachNeighbor(i, [&](size_t j) { total_score += score(j); });
+        if (total_score <= 0.0) return i;
+
+        double target = rng.GetDouble() * total_score;
+        double running_total = 0.0;
+        size_t chosen_patch = i;
+        bool found = false;
+        grid.ForEachNeighbor(i, [&](size_t j) {
+            if (found) return;
+            running_total += score(j);
+            if (running_total >= target) {
+                chosen_patch = j;
+                found = true;
             }
+        });
+        return chosen_patch;
+    }
+
+    // Predators catch prey on the patches touching their own (see
+    // EnablePredation). Every predator picks its prey against the
+    // populations at the start of the phase, and a prey caught by several
+    // predators goes to the earliest in dense order; the others go without.
+    // Caught prey are removed at the end of the phase, freeing their
+    // patches, and each predator's catches are kept for the next Reproduce.
+    // O(predators), with no pairwise distance checks.
+    void Predation() {
+        PhaseTimer timer(profile.predation_seconds);
+        std::vector<uint32_t> eaten; // Store slots of the caught prey, in predator order.
+        std::vector<uint32_t> fed;   // Store slots of the predators that caught them.
+        if (thread_pool) HuntParallel(eaten, fed);
+        else if (batched_random) HuntWith(batch_random, eaten, fed);
+        else HuntWith(random, eaten, fed);
+
+        // Slots survive the removals that shuffle dense indices.
+        for (uint32_t slot : eaten) RemoveOrganismAt(organisms.IndexOfSlot(slot));
+        predator_captures.assign(organisms.Size(), 0);
+        for (uint32_t slot : fed) predator_captures[organisms.IndexOfSlot(slot)]++;
+        last_captures = eaten.size();
+        Count(profile.counters.captures, eaten.size());
+    }
+
+    template <typename RNG>
+    void HuntWith(RNG& source, std::vector<uint32_t>& eaten, std::vector<uint32_t>& fed) {
+        auto&& rng = Counted(source, profile.counters.rng_draws);
+        std::vector<uint8_t> taken(organisms.PreyEnd(), 0); // By prey dense index.
+        for (size_t d = organisms.SpeciesBegin(Species::Predator); d < organisms.Size(); ++d) {
+            size_t j = HuntTarget(rng, d, profile.counters);
+            if (j == patch_resource.size()) continue;
+            uint32_t prey_slot = patch_occupant[j];
+            size_t prey = organisms.IndexOfSlot(prey_slot);
+            if (taken[prey]) continue;
+            taken[prey] = 1;
+            eaten.push_back(prey_slot);
+            fed.push_back(organisms.SlotAt(d));
         }
     }
 
-    void CullDead() {
-        for (auto& patch : patches) {
-            patch.occupants.erase(std::remove_if(
-                patch.occupants.begin(), patch.occupants.end(),
-                [&](Organism* org) {
-                    if (!org->IsPrey() && random.P(predator_death_rate)) {
-                        delete org;
-                        return true;
-                    }
-                    if (org->IsDead()) {
-                        delete org;
-                        return true;
-                    }
-                    return false;
-                }),
-                patch.occupants.end());
+    // Same rule as the sequential phase: predators pick their prey in
+    // parallel and claim its patch, and the smallest dense index wins.
+    void HuntParallel(std::vector<uint32_t>& eaten, std::vector<uint32_t>& fed) {
+        size_t first = organisms.SpeciesBegin(Species::Predator);
+        size_t count = organisms.Count(Species::Predator);
+        size_t none = patch_resource.size();
+        std::vector<size_t> target(count);
+        std::mutex merge_mutex;
+        auto hunt = [&](size_t d, StepCounters& local) {
+            CounterRandom stream = StreamFor(predation_stream, organisms.GetPatch(d));
+            auto&& rng = Counted(stream, local.rng_draws);
+            return HuntTarget(rng, d, local);
+        };
+
+        if (tiles.IsEnabled()) {
+            std::vector<StepCounters> slot_counters(thread_pool->Size());
+            ForEachOrganismByTile(first, count, [&](size_t s, size_t d) {
+                target[d - first] = hunt(d, slot_counters[s]);
+                if (target[d - first] != none) ClaimFromSlot(s, target[d - first], d);
+            });
+            ExchangeClaims();
+            for (const StepCounters& local : slot_counters) MergeCounters(merge_mutex, local);
+        } else {
+            thread_pool->ParallelFor(count, [&](size_t begin, size_t end) {
+                StepCounters local;
+                for (size_t k = begin; k < end; ++k) {
+                    target[k] = hunt(first + k, local);
+                    if (target[k] != none) Claim(target[k], static_cast<uint32_t>(first + k));
+                }
+                MergeCounters(merge_mutex, local);
+            });
+        }
+
+        for (size_t k = 0; k < count; ++k) {
+            if (target[k] == none || !TakeClaim(target[k], static_cast<uint32_t>(first + k))) continue;
+            eaten.push_back(patch_occupant[target[k]]);
+            fed.push_back(organisms.SlotAt(first + k));
         }
     }
 
-    const std::vector<Patch>& GetPatches() const { return patches; }
-    std::vector<Patch>& GetPatchesMutable() { return patches; }
+    // Candidate offspring destinations for a parent in patch i under the
+    // current placement rule.
+    void OffspringTargets(size_t i, std::vector<size_t>& targets) const {
+        targets.clear();
+        if (offspring_placement == OffspringPlacement::ParentPatch) {
+            targets.push_back(i);
+        } else if (grid.IsLocal()) {
+            // Every other patch in the parent's neighborhood.
+            grid.ForEachNeighbor(i, [&](size_t j) {
+                if (j != i) targets.push_back(j);
+            });
+        } else {
+            // Left and right on the grid, whatever the patch order.
+            size_t x = grid.X(i);
+            size_t y = grid.Y(i);
+            if (x > 0) targets.push_back(grid.Index(x - 1, y));
+            if (x + 1 < grid.Width()) targets.push_back(grid.Index(x + 1, y));
+        }
+    }
 
-    double GetAveragePreyAlpha(bool is_prey1) const {
-        double total_alpha = 0.0;
-        int count = 0;
-        for (const auto& patch : patches) {
-            for (Organism* org : patch.occupants) {
-                if (org->IsPrey()) {
-                    if ((is_prey1 && org->GetTau() > 0.5) || (!is_prey1 && org->GetTau() <= 0.5)) {
-                        total_alpha += org->GetAlpha();
-                        count++;
-                    }
+    // Offspring are materialized lazily. Each parent first counts the free
+    // destinations (empty and not yet claimed by an earlier birth this step)
+    // under the placement rule; NearestFreePatch can use any free patch.
+    // Birth trials stop once that capacity is filled, since further
+    // successes could not be placed, so the number placed is still
+    // min(successes, capacity). Destinations are drawn uniformly from the
+    // free candidates, and mutation draws are made only for offspring that
+    // are placed. Parents with no free destination draw nothing.
+    void Reproduce() {
+        PhaseTimer timer(profile.reproduce_seconds);
+        if (thread_pool) ReproduceParallel();
+        else if (batched_random) ReproduceWith(batch_random);
+        else ReproduceWith(random);
+        // Catches feed a single litter.
+        predator_captures.clear();
+    }
+
+    template <typename RNG>
+    void ReproduceWith(RNG& source) {
+        std::vector<Offspring> babies;
+        OccupancyBitmap taken = occupancy; // Occupied, or claimed by a birth this step.
+        std::vector<size_t> targets;
+        std::vector<size_t> free_targets;
+        auto&& rng = Counted(source, profile.counters.rng_draws);
+        BernoulliTrials mutation_trials = MutationTrials();
+
+        for (size_t d = 0; d < organisms.Size(); ++d) {
+            size_t i = organisms.GetPatch(d);
+            double chance;
+            int max_babies;
+            if (!BirthTrials(d, chance, max_babies)) continue;
+
+            bool nearest = offspring_placement == OffspringPlacement::NearestFreePatch;
+            size_t capacity;
+            if (nearest) {
+                capacity = taken.CountFree();
+            } else {
+                OffspringTargets(i, targets);
+                free_targets.clear();
+                for (size_t j : targets) {
+                    if (!taken.Test(j)) free_targets.push_back(j);
+                }
+                capacity = free_targets.size();
+            }
+            if (capacity == 0) continue;
+
+            size_t births = CountBirths(rng, chance, max_babies, capacity);
+            Count(profile.counters.offspring_generated, births);
+
+            for (size_t k = 0; k < births; ++k) {
+                size_t target;
+                if (nearest) {
+                    target = taken.NearestFree(i);
+                } else {
+                    size_t pick = free_targets.size() > 1 ? rng.GetUInt(free_targets.size()) : 0;
+                    target = free_targets[pick];
+                    free_targets.erase(free_targets.begin() + pick);
                 }
+                taken.Set(target);
+
+                double a = organisms.GetAlpha(d);
+                double t = organisms.GetTau(d);
+                double m = organisms.GetMoveRate(d);
+                MutateTraits(rng, mutation_trials, a, t);
+
+                Species species = OffspringSpecies(organisms.GetSpecies(d), a, t, m);
+                babies.push_back({species, a, t, m, patch_zone[target], target});
             }
         }
-        return count > 0 ? total_alpha / count : 0.0;
+
+        // Placed after the loop so newborns do not reproduce this step.
+        for (const Offspring& baby : babies) {
+            Place(baby.species, baby.a, baby.t, baby.m, baby.zone, baby.patch_index);
+        }
     }
 
-    double GetAveragePreyTau(bool is_prey1) const {
-        double total_tau = 0.0;
-        int count = 0;
-        for (const auto& patch : patches) {
-            for (Organism* org : patch.occupants) {
-                if (org->IsPrey()) {
-                    if ((is_prey1 && org->GetTau() > 0.5) || (!is_prey1 && org->GetTau() <= 0.5)) {
-                        total_tau += org->GetTau();
-                        count++;
+    // Parallel reproduction. Capacity and candidates come from the
+    // occupancy at the start of the phase rather than from births earlier in
+    // the loop: each parent picks its targets and claims them, and a target
+    // wanted by several parents goes to the earliest in dense order. An
+    // offspring whose target was lost is not born. Under NearestFreePatch a
+    // parent targets its nearest free patches, one per birth.
+    void ReproduceParallel() {
+        size_t n = organisms.Size();
+        if (n == 0 || occupancy.CountFree() == 0) return; // No room for any birth.
+        litter.resize(n);
+        std::mutex merge_mutex;
+
+        // Plan every litter into its block's or slot's buffer, in visiting
+        // order, and claim the targets.
+        if (tiles.IsEnabled()) {
+            size_t slots = thread_pool->Size();
+            planned_targets.resize(slots);
+            for (auto& planned : planned_targets) planned.clear();
+            std::vector<StepCounters> slot_counters(slots);
+            std::vector<std::vector<size_t>> slot_targets(slots), slot_free_targets(slots);
+            ForEachOrganismByTile(0, n, [&](size_t s, size_t d) {
+                size_t births = PlanLitter(d, planned_targets[s], slot_targets[s], slot_free_targets[s], slot_counters[s]);
+                const size_t* out = planned_targets[s].data() + planned_targets[s].size() - births;
+                for (size_t k = 0; k < births; ++k) ClaimFromSlot(s, out[k], d);
+                litter[d] = static_cast<uint8_t>(births);
+            });
+            ExchangeClaims();
+            for (const StepCounters& local : slot_counters) MergeCounters(merge_mutex, local);
+        } else {
+            planned_targets.resize((n + litter_grain - 1) / litter_grain);
+            thread_pool->ParallelFor(n, [&](size_t begin, size_t end) {
+                StepCounters local;
+                std::vector<size_t>& planned = planned_targets[begin / litter_grain];
+                planned.clear();
+                std::vector<size_t> block_targets;
+                std::vector<size_t> block_free_targets;
+                for (size_t d = begin; d < end; ++d) {
+                    size_t births = PlanLitter(d, planned, block_targets, block_free_targets, local);
+                    for (size_t k = planned.size() - births; k < planned.size(); ++k) {
+                        Claim(planned[k], static_cast<uint32_t>(d));
                     }
+                    litter[d] = static_cast<uint8_t>(births);
+                }
+                MergeCounters(merge_mutex, local);
+            }, litter_grain);
+        }
+
+        litter_offset.resize(n + 1);
+        uint32_t total = 0;
+        for (size_t d = 0; d < n; ++d) {
+            litter_offset[d] = total;
+            total += litter[d];
+        }
+        litter_offset[n] = total;
+        if (total == 0) return;
+        litter_target.resize(total);
+        litter_alpha.resize(total);
+        litter_tau.resize(total);
+
+        // Move the planned targets into dense order.
+        if (tiles.IsEnabled()) {
+            std::vector<size_t> read(planned_targets.size(), 0);
+            ForEachBucketedOrganism(0, [&](size_t s, size_t d) {
+                const size_t* from = planned_targets[s].data() + read[s];
+                std::copy(from, from + litter[d], litter_target.begin() + litter_offset[d]);
+                read[s] += litter[d];
+            });
+        } else {
+            thread_pool->ParallelFor(planned_targets.size(), [&](size_t begin, size_t end) {
+                for (size_t b = begin; b < end; ++b) {
+                    const std::vector<size_t>& planned = planned_targets[b];
+                    std::copy(planned.begin(), planned.end(), litter_target.begin() + litter_offset[b * litter_grain]);
+                }
+            }, 1);
+        }
+
+        // Mutation draws only for offspring whose parent won the target.
+        thread_pool->ParallelFor(n, [&](size_t begin, size_t end) {
+            StepCounters local;
+            for (size_t d = begin; d < end; ++d) {
+                if (litter[d] == 0) continue;
+                CounterRandom stream = StreamFor(mutation_stream, organisms.GetPatch(d));
+                auto&& rng = Counted(stream, local.rng_draws);
+                BernoulliTrials mutation_trials = MutationTrials();
+                for (size_t k = litter_offset[d]; k < litter_offset[d + 1]; ++k) {
+                    if (patch_claim[litter_target[k]].load(std::memory_order_relaxed) != d) continue;
+                    double a = organisms.GetAlpha(d);
+                    double t = organisms.GetTau(d);
+                    MutateTraits(rng, mutation_trials, a, t);
+                    litter_alpha[k] = a;
+                    litter_tau[k] = t;
                 }
             }
+            MergeCounters(merge_mutex, local);
+        });
+
+        std::vector<Offspring> babies;
+        for (size_t d = 0; d < n; ++d) {
+            for (size_t k = litter_offset[d]; k < litter_offset[d + 1]; ++k) {
+                size_t target = litter_target[k];
+                if (!TakeClaim(target, static_cast<uint32_t>(d))) {
+                    Count(profile.counters.offspring_discarded);
+                    continue;
+                }
+                double m = organisms.GetMoveRate(d);
+                Species species = OffspringSpecies(organisms.GetSpecies(d), litter_alpha[k], litter_tau[k], m);
+                babies.push_back({species, litter_alpha[k], litter_tau[k], m, patch_zone[target], target});
+            }
+        }
+
+        // Placed after the loop so newborns do not reproduce this step.
+        for (const Offspring& baby : babies) {
+            Place(baby.species, baby.a, baby.t, baby.m, baby.zone, baby.patch_index);
         }
-        return count > 0 ? total_tau / count : 0.0;
     }
 
-    int GetPrey1Count() const {
-        int count = 0;
-        for (const auto& patch : patches) {
-            for (Organism* org : patch.occupants) {
-                if (org->IsPrey() && org->GetTau() > 0.5) {
-                    count++;
+    // Parallel birth trials for parent d against the occupancy at the start
+    // of the phase. Appends the targets of its offspring to out and returns
+    // how many there are; the caller claims them.
+    size_t PlanLitter(size_t d, std::vector<size_t>& out, std::vector<size_t>& targets, std::vector<size_t>& free_targets,
+                      StepCounters& local) {
+        size_t i = organisms.GetPatch(d);
+        size_t num_patches = patch_resource.size();
+        bool nearest = offspring_placement == OffspringPlacement::NearestFreePatch;
+        double chance;
+        int max_babies;
+        if (!BirthTrials(d, chance, max_babies)) return 0;
+
+        size_t capacity;
+        if (nearest) {
+            capacity = occupancy.CountFree();
+        } else {
+            OffspringTargets(i, targets);
+            free_targets.clear();
+            for (size_t j : targets) {
+                if (!occupancy.Test(j)) free_targets.push_back(j);
+            }
+            capacity = free_targets.size();
+        }
+        if (capacity == 0) return 0;
+
+        CounterRandom stream = StreamFor(birth_stream, i);
+        auto&& rng = Counted(stream, local.rng_draws);
+        size_t births = CountBirths(rng, chance, max_babies, capacity);
+        Count(local.offspring_generated, births);
+
+        size_t after = nearest ? occupancy.NextFree(i) : 0;
+        size_t before = nearest ? occupancy.PrevFree(i) : 0;
+        for (size_t k = 0; k < births; ++k) {
+            if (nearest) {
+                // Walk outward from i, ties going to the lower index.
+                if (before == num_patches || (after != num_patches && after - i < i - before)) {
+                    out.push_back(after);
+                    after = occupancy.NextFree(after + 1);
+                } else {
+                    out.push_back(before);
+                    before = before == 0 ? num_patches : occupancy.PrevFree(before - 1);
                 }
+            } else {
+                size_t pick = free_targets.size() > 1 ? rng.GetUInt(free_targets.size()) : 0;
+                out.push_back(free_targets[pick]);
+                free_targets.erase(free_targets.begin() + pick);
             }
         }
-        return count;
+        return births;
     }
 
-    int GetPrey2Count() const {
-        int count = 0;
-        for (const auto& patch : patches) {
-            for (Organism* org : patch.occupants) {
-                if (org->IsPrey() && org->GetTau() <= 0.5) {
-                    count++;
+    void CullDead() {
+        PhaseTimer timer(profile.cull_seconds);
+        // Prey die only when caught (Predation), so only the predator segment
+        // is visited; backwards iteration keeps removal from skipping anyone.
+        size_t first = organisms.SpeciesBegin(Species::Predator);
+        size_t count = organisms.Count(Species::Predator);
+        if (thread_pool && skip_sampling) {
+            // Skipping is sequential by nature, but needs only about one draw
+            // per death, so a single stream (id past the last patch) serves
+            // every thread count.
+            CounterRandom stream(seed, generation, death_stream, patch_resource.size());
+            CullPredatorsWith(stream, first, count);
+            return;
+        }
+        if (thread_pool) {
+            std::vector<uint8_t> dies(count);
+            Count(profile.counters.rng_draws, count);
+            thread_pool->ParallelFor(count, [&](size_t begin, size_t end) {
+                for (size_t k = begin; k < end; ++k) {
+                    CounterRandom rng = StreamFor(death_stream, organisms.GetPatch(first + k));
+                    dies[k] = rng.P(predator_death_rate);
                 }
+            });
+            for (size_t k = count; k-- > 0;) {
+                if (!dies[k]) continue;
+                RemoveOrganismAt(first + k);
+                Count(profile.counters.deaths);
             }
+            return;
         }
-        return count;
+        if (batched_random) CullPredatorsWith(batch_random, first, count);
+        else CullPredatorsWith(random, first, count);
     }
 
-    int GetPredatorCount() const {
-        int count = 0;
-        for (const auto& patch : patches) {
-            for (Organism* org : patch.occupants) {
-                if (!org->IsPrey()) {
-                    count++;
-                }
+    template <typename RNG>
+    void CullPredatorsWith(RNG& source, size_t first, size_t count) {
+        auto&& rng = Counted(source, profile.counters.rng_draws);
+        if (skip_sampling) {
+            // Jump backwards from one death to the next.
+            size_t remaining = count;
+            for (;;) {
+                uint64_t skip = GeometricSkip(rng, predator_death_rate);
+                if (skip >= remaining) break;
+                remaining -= skip + 1;
+                RemoveOrganismAt(first + remaining);
+                Count(profile.counters.deaths);
             }
+            return;
+        }
+        for (size_t d = first + count; d-- > first;) {
+            if (!rng.P(predator_death_rate)) continue;
+            RemoveOrganismAt(d);
+            Count(profile.counters.deaths);
         }
-        return count;
     }
 
+    size_t GetPatchCount() const { return patch_resource.size(); }
+    double GetResourceLevel(size_t patch_index) const { return patch_resource[patch_index]; }
+    int GetZone(size_t patch_index) const { return patch_zone[patch_index]; }
+
+    // Sets a patch's resource level (stored as float) and reclassifies its
+    // zone, moving any occupant's census count to the new zone. While the
+    // environment is on, the level also becomes the patch's capacity.
+    void SetResourceLevel(size_t patch_index, double level) {
+        patch_resource[patch_index] = static_cast<float>(level);
+        resource_index_stale = true;
+        if (environment_enabled) patch_capacity[patch_index] = patch_resource[patch_index];
+        Reclassify(patch_index, ClassifyZone(patch_resource[patch_index]));
+    }
+
+    // Turns on the environment phase at the end of every Step (see
+    // ResourceField.h): prey eat the resource of their patch, resource
+    // regrows logistically towards each patch's capacity and diffuses to
+    // the four grid neighbors, and predators lay down a decaying danger
+    // field that prey add to the predator count when scoring patches.
+    // Zones follow the resource, but only patches that cross a threshold
+    // are reclassified. The current resource levels become the
+    // capacities; danger starts at zero.
+    void EnableEnvironment(const EnvironmentParams& params = EnvironmentParams()) {
+        environment = params;
+        if (environment_enabled) return;
+        environment_enabled = true;
+        patch_capacity = patch_resource;
+        patch_danger.assign(patch_resource.size(), 0.0f);
+        next_resource.resize(patch_resource.size());
+        next_zone.resize(patch_resource.size());
+        danger_total = 0.0;
+    }
+
+    // Freezes the resource levels where they are and drops the danger field.
+    void DisableEnvironment() {
+        environment_enabled = false;
+        for (auto* field : {&patch_capacity, &patch_danger, &next_resource, &row_major_resource,
+                            &row_major_capacity, &row_major_danger}) {
+            std::vector<float>().swap(*field);
+        }
+        std::vector<int8_t>().swap(next_zone);
+        std::vector<uint8_t>().swap(row_major_prey);
+        std::vector<uint8_t>().swap(row_major_predators);
+    }
+
+    bool IsEnvironmentEnabled() const { return environment_enabled; }
+    const EnvironmentParams& GetEnvironment() const { return environment; }
+    double GetResourceCapacity(size_t patch_index) const {
+        return environment_enabled ? patch_capacity[patch_index] : patch_resource[patch_index];
+    }
+    void SetResourceCapacity(size_t patch_index, double capacity) {
+        if (environment_enabled) patch_capacity[patch_index] = static_cast<float>(capacity);
+    }
+    double GetDangerLevel(size_t patch_index) const {
+        return environment_enabled ? patch_danger[patch_index] : 0.0;
+    }
+
+    // One generation of the environment, after culling so that the census
+    // counts are final. Rows are split between threads when a pool is set;
+    // the result does not depend on the split.
+    void UpdateEnvironment() {
+        PhaseTimer timer(profile.environment_seconds);
+        resource_index_stale = true; // Every patch's level changes.
+        size_t width = grid.Width();
+        size_t height = grid.Height();
+        size_t n = patch_resource.size();
+        bool row_major = grid.Order() == PatchOrder::RowMajor;
+        ResourceField field(environment, Policy::low_zone_max, Policy::medium_zone_max);
+        ResourceField::Arrays arrays;
+        if (row_major) {
+            arrays = {patch_resource.data(), patch_capacity.data(), patch_prey_count.data(),
+                      patch_predator_count.data(), patch_danger.data(), next_resource.data(), next_zone.data()};
+        } else {
+            row_major_resource.resize(n);
+            row_major_capacity.resize(n);
+            row_major_danger.resize(n);
+            row_major_prey.resize(n);
+            row_major_predators.resize(n);
+            for (size_t j = 0; j < n; ++j) {
+                size_t r = grid.RowMajorIndex(j);
+                row_major_resource[r] = patch_resource[j];
+                row_major_capacity[r] = patch_capacity[j];
+                row_major_danger[r] = patch_danger[j];
+                row_major_prey[r] = patch_prey_count[j];
+                row_major_predators[r] = patch_predator_count[j];
+            }
+            arrays = {row_major_resource.data(), row_major_capacity.data(), row_major_prey.data(),
+                      row_major_predators.data(), row_major_danger.data(), next_resource.data(), next_zone.data()};
+        }
+
+        bool torus = grid.Edges() == GridEdges::Torus;
+        if (thread_pool) {
+            thread_pool->ParallelFor(height, [&](size_t begin, size_t end) {
+                field.StepRows(arrays, width, height, torus, begin, end);
+            }, std::max<size_t>(1, 16384 / width));
+        } else {
+            field.StepRows(arrays, width, height, torus, 0, height);
+        }
+
+        if (row_major) {
+            patch_resource.swap(next_resource);
+            ResourceField::ForEachChangedZone(patch_zone.data(), next_zone.data(), n, [&](size_t j) {
+                Reclassify(j, next_zone[j]);
+                Count(profile.counters.zone_changes);
+            });
+            return;
+        }
+        // The results are row-major here; bring them back to storage order.
+        for (size_t j = 0; j < n; ++j) {
+            size_t r = grid.RowMajorIndex(j);
+            patch_resource[j] = next_resource[r];
+            patch_danger[j] = row_major_danger[r];
+            if (next_zone[r] != patch_zone[j]) {
+                Reclassify(j, next_zone[r]);
+                Count(profile.counters.zone_changes);
+            }
+        }
+    }
+
+    // Handle of the patch's occupant, or an invalid handle if it is empty.
+    OrganismHandle GetOccupant(size_t patch_index) const {
+        if (patch_occupant[patch_index] == no_occupant) return {};
+        return organisms.HandleOfSlot(patch_occupant[patch_index]);
+    }
+
+    bool IsOccupied(size_t patch_index) const { return occupancy.Test(patch_index); }
+    size_t GetOccupiedPatchCount() const { return occupancy.CountSet(); }
+
+    // Free patch closest to patch_index in index order, or the patch count if
+    // the world is full.
+    size_t FindNearestFreePatch(size_t patch_index) const { return occupancy.NearestFree(patch_index); }
+
+    // All live organisms, for read-only loops over their traits.
+    const OrganismStore& GetOrganisms() const { return organisms; }
+
+    // Recomputes all census counts from the organism store.
+    void RebuildCensus() {
+        std::fill(patch_prey_count.begin(), patch_prey_count.end(), 0);
+        std::fill(patch_predator_count.begin(), patch_predator_count.end(), 0);
+        census.Clear();
+        for (size_t d = 0; d < organisms.Size(); ++d) {
+            CensusAdd(d, organisms.GetPatch(d));
+        }
+    }
+
+    int GetPatchPreyCount(size_t patch_index) const { return patch_prey_count[patch_index]; }
+    int GetPatchPredatorCount(size_t patch_index) const { return patch_predator_count[patch_index]; }
+    int GetZonePreyCount(int zone) const { return census.PreyCount(zone); }
+    int GetZonePredatorCount(int zone) const { return census.PredatorCount(zone); }
+
+    // Per-group, per-zone counts and trait sums of the live population.
+    const PopulationCensus& GetCensus() const { return census; }
+
+    double GetAveragePreyAlpha(bool is_prey1) const {
+        return census.MeanAlpha(is_prey1 ? CensusGroup::Prey1 : CensusGroup::Prey2);
+    }
+
+    double GetAveragePreyTau(bool is_prey1) const {
+        return census.MeanTau(is_prey1 ? CensusGroup::Prey1 : CensusGroup::Prey2);
+    }
+
+    int GetPrey1Count() const { return census.Count(CensusGroup::Prey1); }
+    int GetPrey2Count() const { return census.Count(CensusGroup::Prey2); }
+    int GetPredatorCount() const { return census.Count(CensusGroup::Predator); }
+
     int GetTotalOrganismCount() const {
-        int count = 0;
-        for (const auto& patch : patches) {
-            count += patch.occupants.size();
+        return static_cast<int>(organisms.Size());
+    }
+
+    // Writes patches, organisms, parameters and random state to a
+    // checkpoint file, with the environment's settings, capacities and
+    // danger field while it is on, and the predation settings with any
+    // catches not yet bred from. Every generator a step uses restarts from
+    // the seed and generation, and std_random is saved exactly, so saving
+    // leaves the world untouched and a run restored from the file draws
+    // the same numbers as the saved one. Returns false if the file could
+    // not be written.
+    bool SaveCheckpoint(const std::string& path) {
+        std::ostringstream rng_text;
+        rng_text << std_random;
+        std::string rng_state = rng_text.str();
+
+        CheckpointHeader header{};
+        std::memcpy(header.magic, CheckpointHeader::file_magic, 8);
+        header.version = CheckpointHeader::current_version;
+        header.header_size = sizeof(CheckpointHeader);
+        header.patch_count = patch_resource.size();
+        header.organism_count = organisms.Size();
+        header.seed = seed;
+        header.generation = generation;
+        header.mutation_rate = mutation_rate;
+        header.mutation_sd = mutation_sd;
+        header.predator_death_rate = predator_death_rate;
+        header.offspring_placement = static_cast<uint8_t>(offspring_placement);
+        header.indexed_prey_movement = indexed_prey_movement;
+        header.batched_random = batched_random;
+        header.skip_sampling = skip_sampling;
+        header.std_random_bytes = rng_state.size();
+        header.environment_enabled = environment_enabled;
+        header.environment = environment;
+        header.predation_enabled = predation_enabled;
+        header.pending_captures = !predator_captures.empty();
+        header.capture_probability = predation.capture_probability;
+        header.conversion = predation.conversion;
+
+        CheckpointLayout layout(header);
+        std::vector<uint8_t> bytes(layout.total, 0);
+        auto put = [&](size_t offset, const void* src, size_t count) {
+            if (count > 0) std::memcpy(bytes.data() + offset, src, count);
+        };
+        put(0, &header, sizeof(header));
+        for (size_t j = 0; j < patch_resource.size(); ++j) {
+            put(layout.resource + grid.RowMajorIndex(j) * sizeof(float), &patch_resource[j], sizeof(float));
+        }
+        if (environment_enabled) {
+            for (size_t j = 0; j < patch_resource.size(); ++j) {
+                put(layout.capacity + grid.RowMajorIndex(j) * sizeof(float), &patch_capacity[j], sizeof(float));
+                put(layout.danger + grid.RowMajorIndex(j) * sizeof(float), &patch_danger[j], sizeof(float));
+            }
+        }
+        for (size_t d = 0; d < organisms.Size(); ++d) {
+            uint8_t species = static_cast<uint8_t>(organisms.GetSpecies(d));
+            int8_t birth_zone = static_cast<int8_t>(organisms.GetBirthZone(d));
+            double a = organisms.GetAlpha(d), t = organisms.GetTau(d), m = organisms.GetMoveRate(d);
+            uint64_t patch_index = grid.RowMajorIndex(organisms.GetPatch(d));
+            put(layout.species + d, &species, 1);
+            put(layout.birth_zone + d, &birth_zone, 1);
+            if (d < predator_captures.size()) put(layout.captures + d, &predator_captures[d], 1);
+            put(layout.alpha + d * sizeof(double), &a, sizeof(double));
+            put(layout.tau + d * sizeof(double), &t, sizeof(double));
+            put(layout.move_rate + d * sizeof(double), &m, sizeof(double));
+            put(layout.patch + d * sizeof(uint64_t), &patch_index, sizeof(uint64_t));
+        }
+        put(layout.std_random, rng_state.data(), rng_state.size());
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return static_cast<bool>(file);
+    }
+
+    // Replaces this world's patches, organisms, parameters and random state
+    // with a checkpoint's. The environment and predation are turned on or
+    // off to match the file, with their settings, the capacities and danger
+    // field, and pending catches. The species function, thread count, tiles
+    // and grid are not stored and stay as they are.
+    // Patches are stored in row-major order, so a file can be loaded
+    // whatever the patch order. Organisms keep their dense order, but
+    // handles taken before the restore are invalid. Returns false, leaving
+    // the world unchanged, if the file is invalid or its patch count
+    // differs from this world's.
+    bool LoadCheckpoint(const CheckpointFile& file) {
+        if (!file.IsValid()) return false;
+        const CheckpointHeader& header = file.Header();
+        if (header.patch_count != patch_resource.size()) return false;
+        if (header.offspring_placement > static_cast<uint8_t>(OffspringPlacement::NearestFreePatch)) return false;
+        if (header.environment_enabled > 1 || header.predation_enabled > 1 || header.pending_captures > 1) return false;
+        CheckpointLayout layout = file.Layout();
+
+        // Unaligned-safe reads from the mapped file.
+        auto get = [&](size_t offset, void* dst, size_t count) {
+            if (count > 0) std::memcpy(dst, file.Section<uint8_t>(offset), count);
+        };
+
+        // Check every organism before touching the world.
+        OccupancyBitmap seen(patch_resource.size());
+        for (size_t d = 0; d < header.organism_count; ++d) {
+            uint8_t species;
+            uint64_t patch_index;
+            get(layout.species + d, &species, 1);
+            get(layout.patch + d * sizeof(uint64_t), &patch_index, sizeof(uint64_t));
+            if (species > static_cast<uint8_t>(Species::Predator)) return false;
+            if (patch_index >= patch_resource.size() || seen.Test(patch_index)) return false;
+            seen.Set(patch_index);
+        }
+
+        seed = header.seed;
+        generation = header.generation;
+        mutation_rate = header.mutation_rate;
+        mutation_sd = header.mutation_sd;
+        predator_death_rate = header.predator_death_rate;
+        offspring_placement = static_cast<OffspringPlacement>(header.offspring_placement);
+        indexed_prey_movement = header.indexed_prey_movement != 0;
+        batched_random = header.batched_random != 0;
+        skip_sampling = header.skip_sampling != 0;
+        ReseedSequential();
+        std::istringstream rng_text(std::string(file.Section<char>(layout.std_random), header.std_random_bytes));
+        rng_text >> std_random;
+
+        for (size_t j = 0; j < patch_resource.size(); ++j) {
+            get(layout.resource + grid.RowMajorIndex(j) * sizeof(float), &patch_resource[j], sizeof(float));
+            patch_zone[j] = static_cast<int8_t>(ClassifyZone(patch_resource[j]));
+        }
+        if (header.environment_enabled) {
+            EnableEnvironment(header.environment);
+            for (size_t j = 0; j < patch_resource.size(); ++j) {
+                get(layout.capacity + grid.RowMajorIndex(j) * sizeof(float), &patch_capacity[j], sizeof(float));
+                get(layout.danger + grid.RowMajorIndex(j) * sizeof(float), &patch_danger[j], sizeof(float));
+            }
+        } else if (environment_enabled) {
+            DisableEnvironment();
+        }
+        resource_index_stale = true;
+        if (header.predation_enabled) {
+            PredationParams params;
+            params.capture_probability = header.capture_probability;
+            params.conversion = header.conversion;
+            EnablePredation(params);
+        } else {
+            DisablePredation();
+        }
+
+        organisms.Clear();
+        predator_captures.clear();
+        occupancy.ClearAll();
+        std::fill(patch_occupant.begin(), patch_occupant.end(), no_occupant);
+        RebuildCensus();
+        organisms.Reserve(header.organism_count);
+        for (size_t d = 0; d < header.organism_count; ++d) {
+            uint8_t species;
+            int8_t birth_zone;
+            double a, t, m;
+            uint64_t patch_index;
+            get(layout.species + d, &species, 1);
+            get(layout.birth_zone + d, &birth_zone, 1);
+            get(layout.alpha + d * sizeof(double), &a, sizeof(double));
+            get(layout.tau + d * sizeof(double), &t, sizeof(double));
+            get(layout.move_rate + d * sizeof(double), &m, sizeof(double));
+            get(layout.patch + d * sizeof(uint64_t), &patch_index, sizeof(uint64_t));
+            // Stored in dense order, so each Add lands at the end of its segment.
+            Place(static_cast<Species>(species), a, t, m, birth_zone, grid.FromRowMajor(patch_index));
+        }
+        if (header.pending_captures) {
+            predator_captures.resize(header.organism_count);
+            get(layout.captures, predator_captures.data(), header.organism_count);
         }
-        return count;
+        return true;
+    }
+
+    bool LoadCheckpoint(const std::string& path) {
+        CheckpointFile file(path);
+        return LoadCheckpoint(file);
     }
 
     void ResetOrganisms(
@@ -326,20 +1687,19 @@ public:
         int initial_predators_medium_resource,
         int initial_predators_high_resource
     ) {
-        for (auto& patch : patches) {
-            for (Organism* org : patch.occupants) {
-                delete org;
-            }
-            patch.occupants.clear();
-        }
+        organisms.Clear();
+        predator_captures.clear();
+        occupancy.ClearAll();
+        std::fill(patch_occupant.begin(), patch_occupant.end(), no_occupant);
+        RebuildCensus();
 
-        std::vector<int> low_resource_patches;
-        std::vector<int> medium_resource_patches;
-        std::vector<int> high_resource_patches;
-        std::vector<int> all_prey_patches;
+        std::vector<size_t> low_resource_patches;
+        std::vector<size_t> medium_resource_patches;
+        std::vector<size_t> high_resource_patches;
+        std::vector<size_t> all_prey_patches;
 
-        for (size_t i = 0; i < patches.size(); ++i) {
-            int zone = ClassifyZone(patches[i].resource_level);
+        for (size_t i = 0; i < patch_resource.size(); ++i) {
+            int zone = patch_zone[i];
             if (zone == 0) low_resource_patches.push_back(i);
             else if (zone == 1) medium_resource_patches.push_back(i);
             else high_resource_patches.push_back(i);
@@ -352,55 +1712,54 @@ public:
         std::shuffle(high_resource_patches.begin(), high_resource_patches.end(), std_random);
         std::shuffle(all_prey_patches.begin(), all_prey_patches.end(), std_random);
 
-        int prey_patch_idx_counter = 0;
+        size_t prey_patch_idx_counter = 0;
 
-        auto add_org_if_empty = [&](Organism* org, int patch_idx, int birth_zone_val = -1) {
-            if (patch_idx >= 0 && patch_idx < (int)patches.size() && patches[patch_idx].occupants.empty()) {
-                if (birth_zone_val != -1) {
-                    org->SetBirthZone(birth_zone_val);
-                } else {
-                    org->SetBirthZone(ClassifyZone(patches[patch_idx].resource_level));
-                }
-                patches[patch_idx].occupants.push_back(org);
+        auto add_org_if_empty = [&](Species species, double a, double t, double m, size_t patch_idx, int birth_zone_val = -1) {
+            if (patch_idx < patch_resource.size() && !occupancy.Test(patch_idx)) {
+                int zone = birth_zone_val != -1 ? birth_zone_val : patch_zone[patch_idx];
+                Place(species, a, t, m, zone, patch_idx);
                 return true;
             }
-            delete org;
             return false;
         };
 
-        for (int i = 0; i < initial_prey1 && prey_patch_idx_counter < (int)all_prey_patches.size(); ++i) {
-            add_org_if_empty(new Prey(0.5, 1.0, 0.5), all_prey_patches[prey_patch_idx_counter++]);
+        // Prey2 is immobile, so it is stored with a move rate of 0.
+        for (int i = 0; i < initial_prey1 && prey_patch_idx_counter < all_prey_patches.size(); ++i) {
+            add_org_if_empty(Species::Prey, 0.5, 1.0, 0.5, all_prey_patches[prey_patch_idx_counter++]);
         }
 
-        for (int i = 0; i < initial_prey2 && prey_patch_idx_counter < (int)all_prey_patches.size(); ++i) {
-             add_org_if_empty(new Prey2(0.5, 0.0, 0.5), all_prey_patches[prey_patch_idx_counter++]);
+        for (int i = 0; i < initial_prey2 && prey_patch_idx_counter < all_prey_patches.size(); ++i) {
+             add_org_if_empty(Species::Prey2, 0.5, 0.0, 0.0, all_prey_patches[prey_patch_idx_counter++]);
         }
 
-        int current_pred_idx_low = 0;
-        int current_pred_idx_medium = 0;
-        int current_pred_idx_high = 0;
+        size_t current_pred_idx_low = 0;
+        size_t current_pred_idx_medium = 0;
+        size_t current_pred_idx_high = 0;
 
         for (int i = 0; i < initial_predators_low_resource; ++i) {
-            if (current_pred_idx_low < (int)low_resource_patches.size()) {
-                int patch_idx = low_resource_patches[current_pred_idx_low++];
-                add_org_if_empty(new Predator(0.5, 0.8, 0.5), patch_idx, 0);
+            if (current_pred_idx_low < low_resource_patches.size()) {
+                size_t patch_idx = low_resource_patches[current_pred_idx_low++];
+                add_org_if_empty(Species::Predator, 0.5, 0.8, 0.5, patch_idx, 0);
             }
         }
 
         for (int i = 0; i < initial_predators_medium_resource; ++i) {
-            if (current_pred_idx_medium < (int)medium_resource_patches.size()) {
-                int patch_idx = medium_resource_patches[current_pred_idx_medium++];
-                add_org_if_empty(new Predator(0.5, 0.8, 0.5), patch_idx, 1);
+            if (current_pred_idx_medium < medium_resource_patches.size()) {
+                size_t patch_idx = medium_resource_patches[current_pred_idx_medium++];
+                add_org_if_empty(Species::Predator, 0.5, 0.8, 0.5, patch_idx, 1);
             }
         }
 
         for (int i = 0; i < initial_predators_high_resource; ++i) {
-            if (current_pred_idx_high < (int)high_resource_patches.size()) {
-                int patch_idx = high_resource_patches[current_pred_idx_high++];
-                add_org_if_empty(new Predator(0.5, 0.8, 0.5), patch_idx, 2);
+            if (current_pred_idx_high < high_resource_patches.size()) {
+                size_t patch_idx = high_resource_patches[current_pred_idx_high++];
+                add_org_if_empty(Species::Predator, 0.5, 0.8, 0.5, patch_idx, 2);
             }
         }
     }
 };
 
-#endif
\ No newline at end of file
+// The runtime-configurable world used by native.cpp and web.cpp.
+using World = BasicWorld<>;
+
+#endif
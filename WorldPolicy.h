@@ -0,0 +1,58 @@
+#ifndef WORLD_POLICY_H
+#define WORLD_POLICY_H
+
+#include "Organism.h"
+#include <functional>
+
+// Compile-time configuration of BasicWorld (see World.h). A policy gives
+// only the zone thresholds, the predator movement weights and the rule
+// that picks an offspring's species; prey scoring, the organism store and
+// the observers are the same for every policy. Thresholds and weights are
+// constexpr, and a species rule without run-time state (as in
+// TauSplitWorldPolicy) is inlined into Reproduce.
+
+// Species rule set at run time with World::SetOffspringSpeciesFunction.
+// Without a function, offspring keep their parent's species.
+class RuntimeSpeciesRule {
+private:
+    std::function<Species(bool, double, double, double)> func;
+
+public:
+    void Set(std::function<Species(bool, double, double, double)> species_func) { func = species_func; }
+
+    Species operator()(Species parent, double a, double t, double m) const {
+        if (!func) return parent;
+        return func(parent != Species::Predator, a, t, m);
+    }
+};
+
+// The rule native.cpp and web.cpp install: predators stay predators, and
+// prey become Prey above tau = 0.5 and Prey2 otherwise.
+struct TauSplitSpeciesRule {
+    Species operator()(Species parent, double, double t, double) const {
+        if (parent == Species::Predator) return Species::Predator;
+        return t > 0.5 ? Species::Prey : Species::Prey2;
+    }
+};
+
+// The runtime-configurable World.
+struct DefaultWorldPolicy {
+    // Resource levels below low_zone_max are zone 0 (low), below
+    // medium_zone_max zone 1 (medium), otherwise zone 2 (high).
+    static constexpr double low_zone_max = 0.33;
+    static constexpr double medium_zone_max = 0.66;
+
+    // Predator destination score a * (t * prey - (1 - t) * predators).
+    static constexpr double predator_alpha = 0.5;
+    static constexpr double predator_tau = 0.9;
+
+    using SpeciesRule = RuntimeSpeciesRule;
+};
+
+// DefaultWorldPolicy with the tau-split species rule fixed at compile
+// time, so offspring creation needs no std::function call.
+struct TauSplitWorldPolicy : DefaultWorldPolicy {
+    using SpeciesRule = TauSplitSpeciesRule;
+};
+
+#endif
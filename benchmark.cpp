@@ -0,0 +1,308 @@
+// Benchmark suite for the simulation engine. Times World::Step and each
+// of its phases, ResetOrganisms and the stats getters over a grid of world
+// sizes, population densities, predator death rates and prey movement
+// modes, with fixed seeds. Prints a summary and writes JSON for tracking
+// throughput across versions.
+//
+//   ./benchmark [--quick] [--sizes 30,100,300,1000] [--densities 0.01,0.1,0.5]
+//       [--death-rates 0.00001,0.02] [--reps 5] [--threads 0] [--seed 1]
+//       [--max-scan-work 5e9] [--batched-random] [--skip-sampling] [--specialized]
+//       [--radius 0] [--patch-order row-major|morton|hilbert] [--tile 0]
+//       [--predation 0]
+//       [--out benchmark.json]
+#include "World.h"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Mean, standard deviation and minimum of repeated measurements.
+struct Summary {
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    size_t samples = 0;
+
+    static Summary Of(const std::vector<double>& values) {
+        Summary s;
+        s.samples = values.size();
+        if (values.empty()) return s;
+        s.min = values[0];
+        for (double v : values) {
+            s.mean += v;
+            s.min = std::min(s.min, v);
+        }
+        s.mean /= values.size();
+        for (double v : values) s.stddev += (v - s.mean) * (v - s.mean);
+        s.stddev = values.size() > 1 ? std::sqrt(s.stddev / (values.size() - 1)) : 0.0;
+        return s;
+    }
+
+    std::string Json() const {
+        std::ostringstream out;
+        out << "{\"mean\": " << mean << ", \"stddev\": " << stddev << ", \"min\": " << min
+            << ", \"samples\": " << samples << "}";
+        return out.str();
+    }
+};
+
+struct BenchmarkCase {
+    int side;
+    double density;
+    double death_rate;
+    bool indexed_movement;
+};
+
+struct BenchmarkOptions {
+    std::vector<int> sizes = {30, 100, 300, 1000};
+    std::vector<double> densities = {0.01, 0.1, 0.5};
+    std::vector<double> death_rates = {0.00001, 0.02};
+    int reps = 5;
+    size_t threads = 0;
+    uint64_t seed = 1;
+    double max_scan_work = 5e9; // Skip global full-scan cases above organisms * patches
+    bool batched_random = false;
+    bool skip_sampling = false;
+    bool specialized = false; // BasicWorld<TauSplitWorldPolicy> instead of World
+    int radius = 0;           // Moore neighborhood radius; 0 keeps global movement
+    std::string patch_order = "row-major";
+    size_t tile = 0;          // Tile side for parallel steps; 0 disables
+    double predation = 0.0;   // Capture probability of the predation phase; 0 disables
+    std::string out = "benchmark.json";
+};
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+using SpecializedWorld = BasicWorld<TauSplitWorldPolicy>;
+
+// Both worlds split offspring species on tau; the specialized one has the
+// rule built in.
+void SetSpeciesRule(World& world) {
+    world.SetOffspringSpeciesFunction([](bool is_prey, double, double t, double) {
+        if (!is_prey) return Species::Predator;
+        return t > 0.5 ? Species::Prey : Species::Prey2;
+    });
+}
+
+void SetSpeciesRule(SpecializedWorld&) {}
+
+// A world of three horizontal resource bands (0.9, 0.5, 0.1), stocked to
+// the requested density: 45% Prey, 45% Prey2, 10% predators split evenly
+// over the zones.
+template <typename WorldType>
+WorldType MakeWorld(const BenchmarkCase& c, const BenchmarkOptions& options) {
+    size_t patches = static_cast<size_t>(c.side) * c.side;
+    WorldType world(c.side, c.side);
+    world.SetSeed(options.seed);
+    world.SetThreadCount(options.threads);
+    world.SetPredatorDeathRate(c.death_rate);
+    world.SetIndexedPreyMovement(c.indexed_movement);
+    world.SetBatchedRandom(options.batched_random);
+    world.SetSkipSampling(options.skip_sampling);
+    SetSpeciesRule(world);
+    if (options.radius > 0) world.SetNeighborhood(Neighborhood::Moore, options.radius);
+    if (options.patch_order == "morton") world.SetPatchOrder(PatchOrder::Morton);
+    else if (options.patch_order == "hilbert") world.SetPatchOrder(PatchOrder::Hilbert);
+    world.SetTileSize(options.tile, options.tile);
+    if (options.predation > 0.0) {
+        PredationParams params;
+        params.capture_probability = options.predation;
+        world.EnablePredation(params);
+    }
+    for (size_t i = 0; i < patches; ++i) {
+        int band = static_cast<int>(3 * world.PatchY(i) / c.side);
+        world.SetResourceLevel(i, band == 0 ? 0.9 : (band == 1 ? 0.5 : 0.1));
+    }
+    return world;
+}
+
+template <typename WorldType>
+void Stock(WorldType& world, const BenchmarkCase& c) {
+    double organisms = c.density * world.GetPatchCount();
+    int prey = static_cast<int>(organisms * 0.45);
+    int predators = static_cast<int>(organisms * 0.1 / 3);
+    world.ResetOrganisms(prey, prey, predators, predators, predators);
+}
+
+template <typename WorldType>
+std::string RunCase(const BenchmarkCase& c, const BenchmarkOptions& options) {
+    std::ostringstream json;
+    json << "    {\"width\": " << c.side << ", \"height\": " << c.side << ", \"density\": " << c.density
+         << ", \"death_rate\": " << c.death_rate << ", \"prey_movement\": \""
+         << (c.indexed_movement ? "indexed" : "scan") << "\"";
+
+    WorldType world = MakeWorld<WorldType>(c, options);
+
+    // ResetOrganisms, in ns per organism placed
+    std::vector<double> reset_ns;
+    for (int r = 0; r < options.reps; ++r) {
+        auto start = Clock::now();
+        Stock(world, c);
+        reset_ns.push_back(ElapsedNs(start) / std::max(1, world.GetTotalOrganismCount()));
+    }
+    size_t organisms = world.GetTotalOrganismCount();
+    json << ", \"organisms\": " << organisms;
+
+    double scan_work = static_cast<double>(organisms) * world.GetPatchCount();
+    if (options.radius == 0 && !c.indexed_movement && scan_work > options.max_scan_work) {
+        json << ", \"skipped\": \"full-scan movement above --max-scan-work\"}";
+        std::cout << std::setw(6) << c.side << std::setw(9) << c.density << std::setw(10) << c.death_rate
+                  << std::setw(9) << "scan" << std::setw(10) << organisms << std::setw(14) << "skipped" << std::endl;
+        return json.str();
+    }
+
+    // Whole steps, then each phase on its own, in ns per organism-step.
+    // Every sample is one call, normalized by the population it started with.
+    std::vector<double> step_ns, move_ns, predation_ns, reproduce_ns, cull_ns;
+    world.Step(); // Warm-up
+    for (int r = 0; r < options.reps; ++r) {
+        double n = std::max(1, world.GetTotalOrganismCount());
+        auto start = Clock::now();
+        world.Step();
+        step_ns.push_back(ElapsedNs(start) / n);
+    }
+    for (int r = 0; r < options.reps; ++r) {
+        double n = std::max(1, world.GetTotalOrganismCount());
+        auto start = Clock::now();
+        world.MoveOrganisms();
+        move_ns.push_back(ElapsedNs(start) / n);
+
+        if (world.IsPredationEnabled()) {
+            n = std::max(1, world.GetTotalOrganismCount());
+            start = Clock::now();
+            world.Predation();
+            predation_ns.push_back(ElapsedNs(start) / n);
+        }
+
+        n = std::max(1, world.GetTotalOrganismCount());
+        start = Clock::now();
+        world.Reproduce();
+        reproduce_ns.push_back(ElapsedNs(start) / n);
+
+        n = std::max(1, world.GetTotalOrganismCount());
+        start = Clock::now();
+        world.CullDead();
+        cull_ns.push_back(ElapsedNs(start) / n);
+    }
+
+    // Stats getters, in ns per call of the whole set
+    std::vector<double> stats_ns;
+    const int stats_calls = 1000;
+    volatile double sink = 0.0;
+    for (int r = 0; r < options.reps; ++r) {
+        auto start = Clock::now();
+        for (int k = 0; k < stats_calls; ++k) {
+            sink = sink + world.GetTotalOrganismCount() + world.GetPrey1Count() + world.GetPrey2Count()
+                 + world.GetPredatorCount() + world.GetAveragePreyAlpha(true) + world.GetAveragePreyTau(true)
+                 + world.GetAveragePreyAlpha(false) + world.GetAveragePreyTau(false);
+        }
+        stats_ns.push_back(ElapsedNs(start) / stats_calls);
+    }
+
+    Summary step = Summary::Of(step_ns);
+    json << ", \"ns_per_organism_step\": {"
+         << "\"Step\": " << step.Json()
+         << ", \"MoveOrganisms\": " << Summary::Of(move_ns).Json();
+    if (world.IsPredationEnabled()) json << ", \"Predation\": " << Summary::Of(predation_ns).Json();
+    json
+         << ", \"Reproduce\": " << Summary::Of(reproduce_ns).Json()
+         << ", \"CullDead\": " << Summary::Of(cull_ns).Json() << "}"
+         << ", \"ResetOrganisms_ns_per_organism\": " << Summary::Of(reset_ns).Json()
+         << ", \"StatsGetters_ns_per_call\": " << Summary::Of(stats_ns).Json() << "}";
+
+    std::cout << std::setw(6) << c.side << std::setw(9) << c.density << std::setw(10) << c.death_rate
+              << std::setw(9) << (c.indexed_movement ? "indexed" : "scan") << std::setw(10) << organisms
+              << std::setw(14) << std::fixed << std::setprecision(1) << step.mean
+              << " +/- " << step.stddev << std::defaultfloat << std::endl;
+    return json.str();
+}
+
+std::vector<double> ParseList(const std::string& text) {
+    std::vector<double> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(std::stod(item));
+    }
+    return values;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--quick") {
+            options.sizes = {30, 100};
+            options.densities = {0.1};
+            options.reps = 3;
+        } else if (arg == "--sizes" && has_value) {
+            options.sizes.clear();
+            for (double v : ParseList(argv[++i])) options.sizes.push_back(static_cast<int>(v));
+        }
+        else if (arg == "--densities" && has_value) options.densities = ParseList(argv[++i]);
+        else if (arg == "--death-rates" && has_value) options.death_rates = ParseList(argv[++i]);
+        else if (arg == "--reps" && has_value) options.reps = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--threads" && has_value) options.threads = std::stoul(argv[++i]);
+        else if (arg == "--seed" && has_value) options.seed = std::stoull(argv[++i]);
+        else if (arg == "--max-scan-work" && has_value) options.max_scan_work = std::stod(argv[++i]);
+        else if (arg == "--batched-random") options.batched_random = true;
+        else if (arg == "--skip-sampling") options.skip_sampling = true;
+        else if (arg == "--specialized") options.specialized = true;
+        else if (arg == "--radius" && has_value) options.radius = std::stoi(argv[++i]);
+        else if (arg == "--patch-order" && has_value) options.patch_order = argv[++i];
+        else if (arg == "--tile" && has_value) options.tile = std::stoul(argv[++i]);
+        else if (arg == "--predation" && has_value) options.predation = std::stod(argv[++i]);
+        else if (arg == "--out" && has_value) options.out = argv[++i];
+        else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << std::setw(6) << "side" << std::setw(9) << "density" << std::setw(10) << "death"
+              << std::setw(9) << "movement" << std::setw(10) << "organisms"
+              << std::setw(14) << "ns/org-step" << std::endl;
+
+    std::vector<std::string> results;
+    for (int side : options.sizes) {
+        for (double density : options.densities) {
+            for (double death_rate : options.death_rates) {
+                for (bool indexed : {false, true}) {
+                    BenchmarkCase c{side, density, death_rate, indexed};
+                    results.push_back(options.specialized ? RunCase<SpecializedWorld>(c, options)
+                                                          : RunCase<World>(c, options));
+                }
+            }
+        }
+    }
+
+    std::ofstream json(options.out);
+    json << "{\n  \"suite\": \"World\",\n  \"format_version\": 1,\n"
+#ifdef __VERSION__
+         << "  \"compiler\": \"" << __VERSION__ << "\",\n"
+#endif
+         << "  \"threads\": " << options.threads << ",\n  \"batched_random\": "
+         << (options.batched_random ? "true" : "false") << ",\n  \"skip_sampling\": "
+         << (options.skip_sampling ? "true" : "false") << ",\n  \"specialized\": "
+         << (options.specialized ? "true" : "false") << ",\n  \"radius\": " << options.radius
+         << ",\n  \"patch_order\": \"" << options.patch_order << "\""
+         << ",\n  \"tile\": " << options.tile
+         << ",\n  \"predation\": " << options.predation
+         << ",\n  \"seed\": " << options.seed
+         << ",\n  \"reps\": " << options.reps << ",\n  \"results\": [\n";
+    for (size_t k = 0; k < results.size(); ++k) {
+        json << results[k] << (k + 1 < results.size() ? ",\n" : "\n");
+    }
+    json << "  ]\n}\n";
+    std::cout << "Wrote " << options.out << std::endl;
+    return 0;
+}
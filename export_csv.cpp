@@ -0,0 +1,28 @@
+// Converts a binary .ppcol stats file written by native.cpp into the CSV
+// layout plots.ipynb reads.
+//
+//   ./export_csv run.ppcol [run.csv]
+#include "ColumnarFile.h"
+#include <filesystem>
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " input.ppcol [output.csv]" << std::endl;
+        return 1;
+    }
+
+    std::string input = argv[1];
+    std::string output = argc > 2 ? argv[2] : std::filesystem::path(input).replace_extension(".csv").string();
+
+    BinaryColumnReader reader(input);
+    if (!reader.IsValid()) {
+        std::cerr << input << " is not a .ppcol file" << std::endl;
+        return 1;
+    }
+
+    // Reuse the CSV sink so exported files match directly written ones.
+    CsvSink csv(output);
+    ExportColumns(reader, csv);
+    return 0;
+}
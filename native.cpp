@@ -1,4 +1,7 @@
 #include "World.h"
+#include "DataCollector.h"
+#include "AsyncSink.h"
+#include "ColumnarFile.h"
 #include "Prey.h"
 #include "Prey2.h"
 #include "Predator.h"
@@ -6,31 +9,50 @@
 #include <iomanip>
 #include <fstream>
 #include <filesystem>
-
-// This function helps us group patches into zones: low, medium, high resource
-int ClassifyZone(double resource_level) {
-    if (resource_level < 0.33) return 0;       // Low
-    else if (resource_level < 0.66) return 1;  // Medium
-    else return 2;                             // High
+#include <thread>
+#include <sstream>
+#include <mutex>
+#include <optional>
+
+// Settings for one simulation run
+struct ExperimentConfig {
+    double predator_death_rate = 0.02;
+    double mutation_rate = 0.05;
+    double mutation_sd = 0.025;
+    int generations = 1000;
+    uint64_t seed = 0;            // 0 keeps the world's random seed
+    size_t threads = 0;           // Threads stepping this world; 0 is the sequential step
+    std::string output_path;      // Empty means evolution_data_deathrate_<rate>.csv
+    bool print_generations = true;
+    int sample_interval = 1;      // Generations between stats rows
+    int histogram_interval = 0;   // Tau histograms; 0 disables
+    int snapshot_interval = 0;    // Spatial snapshots; 0 disables
+    bool binary_output = false;   // .ppcol files instead of CSV (see export_csv)
+    double console_seconds = 0.25; // Minimum time between console rows
+    std::shared_ptr<const CheckpointFile> start_from; // Restore instead of placing founders
+    bool save_checkpoint = false; // Save <output>.ckpt after the last generation
+    bool skip_sampling = false;   // Exact skip/binomial shortcuts for rare events
+    Neighborhood neighborhood = Neighborhood::Global; // Local movement and dispersal
+    int radius = 1;
+    GridEdges edges = GridEdges::Bounded;
+    PatchOrder patch_order = PatchOrder::RowMajor; // Patch storage order; outputs stay row-major
+    size_t tile = 0;              // Tile side for parallel steps; 0 disables
+    bool environment = false;     // Resource consumption, regrowth, diffusion and danger
+    EnvironmentParams environment_params;
+    bool predation = false;       // Predators catch adjacent prey and breed from their catches
+    PredationParams predation_params;
+    std::optional<OffspringPlacement> placement; // Unset keeps the world's (or checkpoint's) rule
+};
+
+// File sink for one output, written on its own thread so formatting and
+// I/O stay off the simulation loop.
+std::shared_ptr<DataSink> OpenOutput(const ExperimentConfig& config, const std::string& stem, const std::string& suffix) {
+    if (config.binary_output) return std::make_shared<AsyncSink>(std::make_shared<BinaryColumnSink>(stem + suffix + ".ppcol"));
+    return std::make_shared<AsyncSink>(std::make_shared<CsvSink>(stem + suffix + ".csv"));
 }
 
-// This function runs the main simulation experiment
-void RunExperiment(double predator_death_rate) {
-    const int width = 60;
-    const int height = 60;
-    const int total_patches = width * height;
-
-    // Create the world and set how predators die
-    World world(total_patches);
-    world.SetPredatorDeathRate(predator_death_rate);
-
-    // Tell the world how to clone organisms properly
-    world.SetCloneFunction([](bool is_prey, double a, double t, double m) {
-        if (!is_prey) return new Predator(a, t, m);
-        if (t > 0.5) return new Prey(a, t, m);
-        return new Prey2(a, t, m);
-    });
-
+// Sets the zone resources and places the founders at each zone's center
+void PopulateWorld(World& world) {
     // Define rectangular zones in the world with different resources
     struct PatchZone {
         int x_start, y_start;
@@ -47,22 +69,21 @@ void RunExperiment(double predator_death_rate) {
     for (const auto& zone_info : zones) {
         for (int y = zone_info.y_start; y < zone_info.y_start + 16; ++y) {
             for (int x = zone_info.x_start; x < zone_info.x_start + 16; ++x) {
-                int index = y * width + x;
-                world.GetPatchesMutable()[index].resource_level = zone_info.resource;
+                world.SetResourceLevel(world.PatchIndex(x, y), zone_info.resource);
             }
         }
     }
 
     // Add initial organisms to center of each zone (simplified distribution)
-    std::vector<int> zone_centers = {
-        (7*width + 7), (27*width + 7), (47*width + 7),
-        (7*width + 27), (27*width + 27), (47*width + 27),
-        (7*width + 47), (27*width + 47), (47*width + 47)
+    std::vector<size_t> zone_centers = {
+        world.PatchIndex(7, 7), world.PatchIndex(7, 27), world.PatchIndex(7, 47),
+        world.PatchIndex(27, 7), world.PatchIndex(27, 27), world.PatchIndex(27, 47),
+        world.PatchIndex(47, 7), world.PatchIndex(47, 27), world.PatchIndex(47, 47)
     };
 
     for(size_t i = 0; i < zones.size(); ++i) {
-        int center_idx = zone_centers[i];
-        int zone_type = ClassifyZone(zones[i].resource);
+        size_t center_idx = zone_centers[i];
+        int zone_type = World::ClassifyZone(zones[i].resource); // 0 low, 1 medium, 2 high
 
         // Add predators
         int num_predators = (zone_type == 2) ? 6 : (zone_type == 1 ? 3 : 0);
@@ -79,103 +100,294 @@ void RunExperiment(double predator_death_rate) {
         }
     }
 
-    // Set up CSV file for output
-    std::string filename = "evolution_data_deathrate_" + std::to_string(static_cast<int>(predator_death_rate * 100000)) + ".csv";
-    std::ofstream csv(filename);
-    csv << "Generation,AvgAlphaPrey1,AvgTauPrey1,AvgAlphaPrey2,AvgTauPrey2,"
-        << "Prey1Low,Prey1Med,Prey1High,Prey2Low,Prey2Med,Prey2High,"
-        << "PredatorLow,PredatorMed,PredatorHigh\n";
+}
 
-    // Run the simulation
-    for (int gen = 0; gen <= 1000; ++gen) { // Run for 1000 generations
-        world.Step();
+// This function runs the main simulation experiment
+void RunExperiment(const ExperimentConfig& config) {
+    const int width = 60;
+    const int height = 60;
 
-        // Collect stats
-        double alpha1 = 0.0, tau1 = 0.0;
-        double alpha2 = 0.0, tau2 = 0.0;
-        int count1 = 0, count2 = 0;
-        int p1low = 0, p1med = 0, p1high = 0;
-        int p2low = 0, p2med = 0, p2high = 0;
-        int predlow = 0, predmed = 0, predhigh = 0;
-
-        for (const auto& patch : world.GetPatches()) {
-            int zone = ClassifyZone(patch.resource_level);
-            for (Organism* org : patch.occupants) {
-                if (!org->IsPrey()) {
-                    if (zone == 0) predlow++;
-                    else if (zone == 1) predmed++;
-                    else predhigh++;
-                } else if (org->GetTau() > 0.5) { // Prey1 (blue)
-                    alpha1 += org->GetAlpha();
-                    tau1 += org->GetTau();
-                    count1++;
-                    if (zone == 0) p1low++;
-                    else if (zone == 1) p1med++;
-                    else p1high++;
-                } else { // Prey2 (cyan)
-                    alpha2 += org->GetAlpha();
-                    tau2 += org->GetTau();
-                    count2++;
-                    if (zone == 0) p2low++;
-                    else if (zone == 1) p2med++;
-                    else p2high++;
-                }
-            }
+    // Start from a saved state, or build the zones and founders from scratch
+    World world(width, height);
+    world.SetPatchOrder(config.patch_order);
+    if (config.start_from) {
+        if (!world.LoadCheckpoint(*config.start_from)) {
+            std::cerr << "Checkpoint does not fit a " << width << "x" << height << " world" << std::endl;
+            return;
         }
+    } else {
+        PopulateWorld(world);
+    }
+    world.SetNeighborhood(config.neighborhood, config.radius, config.edges);
+
+    // Set how predators die and how traits mutate; a seed branches a
+    // restored run onto its own random streams
+    world.SetPredatorDeathRate(config.predator_death_rate);
+    world.SetMutationRate(config.mutation_rate);
+    world.SetMutationSD(config.mutation_sd);
+    if (config.seed != 0) world.SetSeed(config.seed);
+    if (config.skip_sampling) world.SetSkipSampling(true);
+    if (config.placement) world.SetOffspringPlacement(*config.placement);
+
+    // The zone layout becomes each patch's resource capacity
+    if (config.environment) world.EnableEnvironment(config.environment_params);
+    if (config.predation) world.EnablePredation(config.predation_params);
+
+    // Results depend only on the seed, not the thread count
+    world.SetThreadCount(config.threads);
+    world.SetTileSize(config.tile, config.tile);
+
+    // Tell the world which species offspring become after mutation
+    world.SetOffspringSpeciesFunction([](bool is_prey, double, double t, double) {
+        if (!is_prey) return Species::Predator;
+        if (t > 0.5) return Species::Prey;
+        return Species::Prey2;
+    });
 
-        // Get averages for the traits
-        alpha1 = count1 ? alpha1 / count1 : 0.0;
-        tau1 = count1 ? tau1 / count1 : 0.0;
-        alpha2 = count2 ? alpha2 / count2 : 0.0;
-        tau2 = count2 ? tau2 / count2 : 0.0;
+    // Register what to record and how often
+    std::string filename = config.output_path;
+    if (filename.empty()) filename = "evolution_data_deathrate_" + std::to_string(static_cast<int>(config.predator_death_rate * 100000)) + ".csv";
+    std::string stem = std::filesystem::path(filename).replace_extension("").string();
 
-        // Save to CSV
-        csv << gen << "," << alpha1 << "," << tau1 << "," << alpha2 << "," << tau2 << ","
-            << p1low << "," << p1med << "," << p1high << ","
-            << p2low << "," << p2med << "," << p2high << ","
-            << predlow << "," << predmed << "," << predhigh << "\n";
+    DataCollector collector;
+    collector.Add(std::make_unique<PopulationStatsObserver>(), OpenOutput(config, stem, ""), config.sample_interval);
+    if (config.print_generations) {
+        auto console = std::make_shared<ConsoleSink>(std::cout, config.console_seconds);
+        collector.Add(std::make_unique<PopulationStatsObserver>(), std::make_shared<AsyncSink>(console), config.sample_interval);
+    }
+    if (config.histogram_interval > 0) {
+        collector.Add(std::make_unique<TraitHistogramObserver>(TraitHistogramObserver::Trait::Tau, CensusGroup::Prey1),
+                      OpenOutput(config, stem, "_tau_prey1_histogram"), config.histogram_interval);
+        collector.Add(std::make_unique<TraitHistogramObserver>(TraitHistogramObserver::Trait::Tau, CensusGroup::Prey2),
+                      OpenOutput(config, stem, "_tau_prey2_histogram"), config.histogram_interval);
+    }
+    if (config.snapshot_interval > 0) {
+        collector.Add(std::make_unique<SpatialSnapshotObserver>(world.GetPatchCount()),
+                      OpenOutput(config, stem, "_snapshots"), config.snapshot_interval);
+    }
+    if (config.environment) {
+        collector.Add(std::make_unique<EnvironmentObserver>(), OpenOutput(config, stem, "_environment"), config.sample_interval);
+    }
+    if (config.predation) {
+        collector.Add(std::make_unique<PredationObserver>(), OpenOutput(config, stem, "_predation"), config.sample_interval);
+    }
+    if (World::IsProfilingEnabled()) {
+        // Built with -DWORLD_PROFILE: per-phase timings and event counts
+        collector.Add(std::make_unique<StepProfileObserver>(), OpenOutput(config, stem, "_profile"), config.sample_interval);
+    }
 
-        // Print to screen
-        std::cout << gen << "\t" << alpha1 << "\t" << tau1 << "\t"
-                  << alpha2 << "\t" << tau2 << "\t"
-                  << p1low << "\t" << p1med << "\t" << p1high << "\t"
-                  << p2low << "\t" << p2med << "\t" << p2high << "\t"
-                  << predlow << "\t" << predmed << "\t" << predhigh << std::endl;
+    // Run the simulation
+    for (int gen = 0; gen <= config.generations; ++gen) {
+        world.Step();
+        collector.Collect(world, gen);
     }
+    collector.Flush();
 
-    csv.close();
+    if (config.save_checkpoint && !world.SaveCheckpoint(stem + ".ckpt")) {
+        std::cerr << "Could not write " << stem << ".ckpt" << std::endl;
+    }
 }
 
-int main() {
-    std::cout << std::fixed << std::setprecision(5);
-
-    std::cout << "Running experiment with low predator death rate (0.02):" << std::endl;
-    RunExperiment(0.02);
-
-    return 0;
+// Expands a comma-separated list such as "0.02,0.04,0.06".
+std::vector<double> ParseList(const std::string& text) {
+    std::vector<double> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(std::stod(item));
+    }
+    return values;
 }
 
+// Per-run seed from the sweep seed and run number (SplitMix64 finalizer),
+// so every run gets its own well-separated stream.
+uint64_t RunSeed(uint64_t sweep_seed, uint64_t run) {
+    uint64_t z = sweep_seed + (run + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return z != 0 ? z : 1;
+}
 
+// Runs every (death rate, mutation rate, mutation SD, replicate)
+// combination on a work-stealing thread pool. Each run steps its world on
+// one thread with its own seed and writes its own CSV into out_dir;
+// runs.csv lists the parameters and seed behind every file, so any run
+// can be reproduced on its own.
+void RunSweep(const ExperimentConfig& base, const std::vector<double>& death_rates,
+              const std::vector<double>& mutation_rates, const std::vector<double>& mutation_sds,
+              int replicates, uint64_t sweep_seed, size_t threads, const std::string& out_dir) {
+    std::filesystem::create_directories(out_dir);
+    std::vector<ExperimentConfig> runs;
+    for (double death_rate : death_rates) {
+        for (double mutation_rate : mutation_rates) {
+            for (double mutation_sd : mutation_sds) {
+                for (int rep = 0; rep < replicates; ++rep) {
+                    ExperimentConfig config = base;
+                    config.predator_death_rate = death_rate;
+                    config.mutation_rate = mutation_rate;
+                    config.mutation_sd = mutation_sd;
+                    config.threads = 0;
+                    config.seed = RunSeed(sweep_seed, runs.size());
+                    config.print_generations = false;
+                    std::ostringstream name;
+                    name << "run_" << std::setw(4) << std::setfill('0') << runs.size()
+                         << "_kp_" << death_rate << "_mu_" << mutation_rate
+                         << "_sd_" << mutation_sd << "_rep_" << rep << (base.binary_output ? ".ppcol" : ".csv");
+                    config.output_path = (std::filesystem::path(out_dir) / name.str()).string();
+                    runs.push_back(config);
+                }
+            }
+        }
+    }
 
+    std::ofstream manifest(std::filesystem::path(out_dir) / "runs.csv");
+    manifest << "Run,PredatorDeathRate,MutationRate,MutationSD,Replicate,Seed,File\n";
+    for (size_t i = 0; i < runs.size(); ++i) {
+        manifest << i << "," << runs[i].predator_death_rate << "," << runs[i].mutation_rate << ","
+                 << runs[i].mutation_sd << "," << i % replicates << "," << runs[i].seed << ","
+                 << std::filesystem::path(runs[i].output_path).filename().string() << "\n";
+    }
+    manifest.close();
+
+    std::mutex print_mutex;
+    size_t finished = 0;
+    ThreadPool pool(threads);
+    for (const ExperimentConfig& config : runs) {
+        pool.Submit([&, config] {
+            RunExperiment(config);
+            std::lock_guard<std::mutex> lock(print_mutex);
+            std::cout << "[" << ++finished << "/" << runs.size() << "] " << config.output_path << std::endl;
+        });
+    }
+    pool.Wait();
+}
 
+// Usage:
+//   ./native_project                 one run at death rate 0.02
+//   ./native_project --death-rate 0.08 --seed 3   one run with that rate and seed
+//   ./native_project --sweep [--death-rates 0.02,0.04] [--mutation-rates 0.05]
+//       [--mutation-sds 0.025] [--replicates 1] [--generations 1000]
+//       [--sample-interval 1] [--histogram-interval 0] [--snapshot-interval 0]
+//       [--seed 1] [--threads N] [--out sweep] [--binary] [--console-interval 0.25]
+//       [--load-checkpoint burned_in.ckpt] [--save-checkpoint] [--skip-sampling]
+//       [--neighborhood global|moore|vonneumann] [--radius 1] [--torus]
+//       [--patch-order row-major|morton|hilbert] [--tile 20]
+//       [--environment] [--consumption 0.1] [--regrowth 0.05] [--diffusion 0.05]
+//       [--danger-deposit 1] [--danger-decay 0.1]
+//       [--predation] [--capture-probability 0.5] [--conversion 1]
+//       [--placement parent|adjacent|nearest]
+int main(int argc, char* argv[]) {
+    std::cout << std::fixed << std::setprecision(5);
 
+    bool sweep = false;
+    std::vector<double> death_rates = {0.02, 0.04, 0.06, 0.08, 0.1, 0.12, 0.14};
+    std::vector<double> mutation_rates = {0.05};
+    std::vector<double> mutation_sds = {0.025};
+    int replicates = 1;
+    ExperimentConfig base;
+    uint64_t sweep_seed = 1;
+    size_t threads = 0; // 0: sweeps use every core, a single run steps sequentially
+    std::string out_dir = "sweep";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--sweep") sweep = true;
+        else if (arg == "--death-rates" && has_value) death_rates = ParseList(argv[++i]);
+        else if (arg == "--mutation-rates" && has_value) mutation_rates = ParseList(argv[++i]);
+        else if (arg == "--mutation-sds" && has_value) mutation_sds = ParseList(argv[++i]);
+        else if (arg == "--replicates" && has_value) replicates = std::stoi(argv[++i]);
+        else if (arg == "--generations" && has_value) base.generations = std::stoi(argv[++i]);
+        else if (arg == "--sample-interval" && has_value) base.sample_interval = std::stoi(argv[++i]);
+        else if (arg == "--histogram-interval" && has_value) base.histogram_interval = std::stoi(argv[++i]);
+        else if (arg == "--snapshot-interval" && has_value) base.snapshot_interval = std::stoi(argv[++i]);
+        else if (arg == "--death-rate" && has_value) base.predator_death_rate = std::stod(argv[++i]);
+        else if (arg == "--seed" && has_value) sweep_seed = base.seed = std::stoull(argv[++i]);
+        else if (arg == "--threads" && has_value) threads = std::stoul(argv[++i]);
+        else if (arg == "--out" && has_value) out_dir = argv[++i];
+        else if (arg == "--binary") base.binary_output = true;
+        else if (arg == "--save-checkpoint") base.save_checkpoint = true;
+        else if (arg == "--skip-sampling") base.skip_sampling = true;
+        else if (arg == "--neighborhood" && has_value) {
+            std::string kind = argv[++i];
+            if (kind == "moore") base.neighborhood = Neighborhood::Moore;
+            else if (kind == "vonneumann") base.neighborhood = Neighborhood::VonNeumann;
+            else if (kind == "global") base.neighborhood = Neighborhood::Global;
+            else {
+                std::cerr << "Unknown neighborhood: " << kind << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--radius" && has_value) base.radius = std::stoi(argv[++i]);
+        else if (arg == "--torus") base.edges = GridEdges::Torus;
+        else if (arg == "--tile" && has_value) base.tile = std::stoul(argv[++i]);
+        else if (arg == "--environment") base.environment = true;
+        else if (arg == "--consumption" && has_value) base.environment_params.consumption = std::stof(argv[++i]);
+        else if (arg == "--regrowth" && has_value) base.environment_params.regrowth = std::stof(argv[++i]);
+        else if (arg == "--diffusion" && has_value) base.environment_params.diffusion = std::stof(argv[++i]);
+        else if (arg == "--danger-deposit" && has_value) base.environment_params.danger_deposit = std::stof(argv[++i]);
+        else if (arg == "--danger-decay" && has_value) base.environment_params.danger_decay = std::stof(argv[++i]);
+        else if (arg == "--predation") base.predation = true;
+        else if (arg == "--capture-probability" && has_value) base.predation_params.capture_probability = std::stod(argv[++i]);
+        else if (arg == "--conversion" && has_value) base.predation_params.conversion = std::stod(argv[++i]);
+        else if (arg == "--patch-order" && has_value) {
+            std::string order = argv[++i];
+            if (order == "morton") base.patch_order = PatchOrder::Morton;
+            else if (order == "hilbert") base.patch_order = PatchOrder::Hilbert;
+            else if (order == "row-major") base.patch_order = PatchOrder::RowMajor;
+            else {
+                std::cerr << "Unknown patch order: " << order << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--load-checkpoint" && has_value) {
+            // Mapped once and shared by every run of a sweep
+            auto checkpoint = std::make_shared<const CheckpointFile>(argv[++i]);
+            if (checkpoint->Version() != 0 && checkpoint->Version() != CheckpointHeader::current_version) {
+                std::cerr << "Unsupported checkpoint version " << checkpoint->Version() << " in " << argv[i]
+                          << " (this build reads version " << CheckpointHeader::current_version << ")" << std::endl;
+                return 1;
+            }
+            if (!checkpoint->IsValid()) {
+                std::cerr << "Not a valid checkpoint: " << argv[i] << std::endl;
+                return 1;
+            }
+            base.start_from = checkpoint;
+        }
+        else if (arg == "--console-interval" && has_value) base.console_seconds = std::stod(argv[++i]);
+        else if (arg == "--placement" && has_value) {
+            std::string rule = argv[++i];
+            if (rule == "parent") base.placement = OffspringPlacement::ParentPatch;
+            else if (rule == "adjacent") base.placement = OffspringPlacement::AdjacentPatch;
+            else if (rule == "nearest") base.placement = OffspringPlacement::NearestFreePatch;
+            else {
+                std::cerr << "Unknown placement: " << rule << std::endl;
+                return 1;
+            }
+        }
+        else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return 1;
+        }
+    }
 
+    // Under ParentPatch no offspring is ever placed, so predators could not
+    // breed from their catches. A restored run keeps its checkpoint's rule
+    if (base.predation && !base.placement && !base.start_from) base.placement = OffspringPlacement::AdjacentPatch;
 
+    if (sweep) {
+        RunSweep(base, death_rates, mutation_rates, mutation_sds, std::max(1, replicates),
+                 sweep_seed, threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency()), out_dir);
+        return 0;
+    }
 
+    std::cout << "Running experiment with predator death rate " << base.predator_death_rate
+              << ", mutation rate " << base.mutation_rate << ", mutation SD " << base.mutation_sd;
+    if (base.seed != 0) std::cout << ", seed " << base.seed;
+    std::cout << ":" << std::endl;
+    base.threads = threads;
+    RunExperiment(base);
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+    return 0;
+}
@@ -0,0 +1,1061 @@
+// Behavior checks for the simulation engine. Each test builds a small
+// world and checks one rule; the program prints every failed check and
+// exits non-zero if there was one.
+//
+//   ./compile-tests.sh
+#include "World.h"
+#include "AsyncSink.h"
+#include "ColumnarFile.h"
+#include "FenwickTree.h"
+#include "OccupancyBitmap.h"
+#include "PatchScoreKernel.h"
+#include "DataCollector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+static int failures = 0;
+
+static void Check(bool condition, const std::string& what) {
+    if (condition) return;
+    std::cerr << "FAILED: " << what << "\n";
+    failures++;
+}
+
+// True if both worlds hold the same organisms in the same dense order and
+// the same resource and danger on every patch.
+static bool SameState(const World& a, const World& b) {
+    const OrganismStore& x = a.GetOrganisms();
+    const OrganismStore& y = b.GetOrganisms();
+    if (a.GetGeneration() != b.GetGeneration() || x.Size() != y.Size()) return false;
+    for (size_t d = 0; d < x.Size(); ++d) {
+        if (x.GetSpecies(d) != y.GetSpecies(d) || x.GetPatch(d) != y.GetPatch(d) ||
+            x.GetAlpha(d) != y.GetAlpha(d) || x.GetTau(d) != y.GetTau(d) ||
+            x.GetMoveRate(d) != y.GetMoveRate(d) || x.GetBirthZone(d) != y.GetBirthZone(d)) {
+            return false;
+        }
+    }
+    for (size_t j = 0; j < a.GetPatchCount(); ++j) {
+        if (a.GetResourceLevel(j) != b.GetResourceLevel(j) || a.GetDangerLevel(j) != b.GetDangerLevel(j)) return false;
+    }
+    return true;
+}
+
+// True if an estimate lies within five standard errors of its expected
+// value.
+static bool Near(double estimate, double expected, double standard_error) {
+    return std::abs(estimate - expected) <= 5.0 * standard_error + 1e-12;
+}
+
+// Returns the same draw every time, to feed fixed values to a sampler.
+struct FixedDraw {
+    double value;
+    double GetDouble() { return value; }
+};
+
+// For fixed draws, the per-zone predator tables pick the same patch as the
+// original linear roulette over every patch: normalized scores summed in
+// patch order, the first patch whose running total reaches the draw, and
+// the current patch if none does. Draws include every running total
+// exactly and the values either side of it, and predator patches score
+// below zero. A draw of exactly 0 is left out: the linear scan stops on
+// whichever patch comes first, score zero or not, while the table only
+// ever picks patches that score above zero.
+static void TestPredatorTablesMatchRoulette() {
+    World world(23 * 19);
+    std::mt19937 setup(37);
+    std::uniform_real_distribution<double> level(0.0, 1.0);
+    std::discrete_distribution<int> occupant({5, 3, 2}); // Empty, prey, predator.
+    for (size_t j = 0; j < world.GetPatchCount(); ++j) {
+        world.SetResourceLevel(j, level(setup));
+        int kind = occupant(setup);
+        if (kind == 1) world.AddOrganism(Species::Prey, 0.5, 0.8, 0.0, j);
+        if (kind == 2) world.AddOrganism(Species::Predator, 0.5, 0.8, 0.0, j);
+    }
+
+    const double a = 0.5;
+    const double t = 0.9;
+    const size_t current_patch = 5;
+    bool same = true;
+    for (int zone = 0; zone < 3; ++zone) {
+        std::vector<double> scores(world.GetPatchCount(), 0.0);
+        for (size_t j = 0; j < scores.size(); ++j) {
+            if (world.GetZone(j) != zone) continue;
+            scores[j] = a * (t * world.GetPatchPreyCount(j) - (1 - t) * world.GetPatchPredatorCount(j));
+        }
+        double total_score = 0.0;
+        for (double score : scores) total_score += score;
+        same = same && total_score > 0.0;
+        for (double& score : scores) score /= total_score;
+
+        std::vector<double> draws;
+        for (int k = 1; k <= 2000; ++k) draws.push_back(k / 2000.0);
+        double running_total = 0.0;
+        for (double score : scores) {
+            running_total += score;
+            draws.push_back(running_total);
+            draws.push_back(std::nextafter(running_total, 0.0));
+            draws.push_back(std::nextafter(running_total, 2.0));
+        }
+        for (double r_val : draws) {
+            if (r_val <= 0.0 || r_val >= 1.0) continue;
+            size_t expected = current_patch;
+            running_total = 0.0;
+            for (size_t k = 0; k < scores.size(); ++k) {
+                running_total += scores[k];
+                if (r_val <= running_total) {
+                    expected = k;
+                    break;
+                }
+            }
+            FixedDraw rng{r_val};
+            same = same && world.ChoosePredatorDestination(rng, zone, current_patch) == expected;
+        }
+    }
+    Check(same, "predator tables pick the same patch as the linear roulette");
+}
+
+// After random resource changes, interleaved with uses of the index, the
+// resource index matches a tree built fresh from the current levels.
+static void TestResourceIndexMatchesFreshBuild() {
+    World world(17 * 13);
+    std::mt19937 rng(29);
+    std::uniform_int_distribution<size_t> pick(0, world.GetPatchCount() - 1);
+    std::uniform_real_distribution<double> level(-0.2, 1.3);
+    for (int change = 0; change < 2000; ++change) {
+        world.SetResourceLevel(pick(rng), level(rng));
+        if (change % 7 == 0) world.GetResourceIndex();
+    }
+    std::vector<double> weights(world.GetPatchCount());
+    for (size_t j = 0; j < weights.size(); ++j) weights[j] = std::max(0.0, world.GetResourceLevel(j));
+    FenwickTree fresh;
+    fresh.Assign(weights);
+    const FenwickTree& index = world.GetResourceIndex();
+    bool same = index.Size() == fresh.Size() && index.Total() == fresh.Total();
+    for (size_t k = 0; k <= weights.size(); ++k) same = same && index.PrefixSum(k) == fresh.PrefixSum(k);
+    Check(same, "the resource index matches a fresh build after level changes");
+}
+
+// Indexed prey movement draws each patch as often as a linear roulette
+// over max(0, score) does, including when danger outweighs resource on
+// many patches and the rejection step has to turn proposals down.
+static void TestIndexedPreyMovesMatchRoulette() {
+    World world(20 * 15);
+    world.SetIndexedPreyMovement(true);
+    std::mt19937 setup(31);
+    std::uniform_real_distribution<double> level(-0.1, 1.4);
+    std::bernoulli_distribution predator_here(0.2);
+    for (size_t j = 0; j < world.GetPatchCount(); ++j) {
+        world.SetResourceLevel(j, level(setup));
+        if (predator_here(setup)) world.AddOrganism(Species::Predator, 0.5, 0.8, 0.0, j);
+    }
+    world.GetResourceIndex();
+
+    const int samples = 200000;
+    bool same = true;
+    for (double t : {0.8, 0.45}) {
+        const double a = 0.7;
+        std::vector<double> weights(world.GetPatchCount());
+        for (size_t j = 0; j < weights.size(); ++j) {
+            double danger = static_cast<double>(world.GetPatchPredatorCount(j));
+            weights[j] = std::max(0.0, a * (t * world.GetResourceLevel(j) - (1 - t) * danger));
+        }
+        double total = 0.0;
+        for (double w : weights) total += w;
+
+        emp::Random rng(7);
+        std::vector<double> indexed(weights.size(), 0.0), linear(weights.size(), 0.0);
+        for (int i = 0; i < samples; ++i) {
+            size_t j = world.ChoosePreyDestinationIndexed(rng, a, t, weights.size());
+            if (j >= weights.size()) {
+                same = false;
+                break;
+            }
+            indexed[j] += 1.0 / samples;
+
+            double r_val = rng.GetDouble() * total;
+            double running_total = 0.0;
+            for (size_t k = 0; k < weights.size(); ++k) {
+                running_total += weights[k];
+                if (r_val < running_total) {
+                    linear[k] += 1.0 / samples;
+                    break;
+                }
+            }
+        }
+        for (size_t j = 0; j < weights.size(); ++j) {
+            double p = weights[j] / total;
+            double standard_error = std::sqrt(2.0 * p * (1 - p) / samples);
+            same = same && (p > 0.0 || indexed[j] == 0.0) && Near(indexed[j], linear[j], standard_error);
+        }
+    }
+    Check(same, "indexed prey moves match the max(0, score) roulette");
+}
+
+// The vectorized kernel (AVX-512, AVX2 or SIMD128, whichever the build
+// targets) picks the same patch as a plain scalar roulette over the same
+// scores, on random resource, prey, predator and zone arrays of every
+// length around the vector width, in prey mode and in predator mode with
+// its birth-zone mask, including negative scores and targets past the
+// total.
+static void TestPatchScoreKernelMatchesScalar() {
+    std::mt19937 rng(31);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    bool total_matches = true, find_matches = true;
+    for (int trial = 0; trial < 400; ++trial) {
+        size_t count = 1 + trial % 37;
+        std::vector<float> resource(count);
+        std::vector<uint8_t> prey(count), predators(count);
+        std::vector<int8_t> zones(count);
+        for (size_t j = 0; j < count; ++j) {
+            resource[j] = static_cast<float>(unit(rng));
+            prey[j] = static_cast<uint8_t>(unit(rng) < 0.5 ? 1 : 0);
+            predators[j] = static_cast<uint8_t>(unit(rng) < 0.2 ? 1 + trial % 3 : 0);
+            zones[j] = static_cast<int8_t>(unit(rng) * 3);
+        }
+        double a = unit(rng), t = unit(rng);
+        bool predator_mode = trial % 4 >= 2;
+        int birth_zone = trial % 3;
+        PatchScoreKernel kernel(resource.data(), prey.data(), predators.data(), zones.data(), count);
+        if (predator_mode) kernel.SetPredatorScoring(a, t, birth_zone);
+        else kernel.SetPreyScoring(a, t);
+
+        std::vector<double> scores(count);
+        double total = 0.0;
+        for (size_t j = 0; j < count; ++j) {
+            double threat = predators[j];
+            if (predator_mode) scores[j] = zones[j] == birth_zone ? a * (t * prey[j] - (1 - t) * threat) : 0.0;
+            else scores[j] = a * (t * resource[j] - (1 - t) * threat);
+            total += scores[j];
+        }
+        auto roulette = [&](double target) {
+            double running = 0.0;
+            size_t last_positive = count;
+            for (size_t j = 0; j < count; ++j) {
+                if (scores[j] > 0.0) last_positive = j;
+                running += scores[j];
+                if (running >= target) return j;
+            }
+            return last_positive;
+        };
+
+        total_matches = total_matches && std::abs(kernel.Total() - total) <= 1e-9 * (1.0 + std::abs(total));
+        for (int draw = 0; draw < 20; ++draw) {
+            double target = unit(rng) * total;
+            find_matches = find_matches && kernel.Find(target) == roulette(target);
+        }
+        double beyond = std::abs(total) * 2.0 + 1.0;
+        find_matches = find_matches && kernel.Find(beyond) == roulette(beyond);
+    }
+    Check(total_matches, "the patch score kernel total matches the scalar sum");
+    Check(find_matches, "the patch score kernel picks the same patch as the scalar roulette");
+}
+
+// Prey2 never moves, so the store keeps a zero move rate for every Prey2,
+// whatever rate its parent had.
+static void TestPrey2StoredImmobile() {
+    OrganismStore store;
+    store.Add(Species::Prey, 0.5, 0.8, 0.7, 1, 0);
+    store.Add(Species::Prey2, 0.5, 0.2, 0.7, 1, 1);
+    Check(store.GetMoveRate(0) == 0.7 && store.GetMoveRate(1) == 0.0, "the store gives Prey2 a zero move rate");
+}
+
+// Every bit-scan query agrees with a plain scan over random bitmaps of
+// sizes around the 64-bit word boundaries, at several densities.
+static void TestOccupancyBitmapMatchesScan() {
+    std::mt19937 rng(3);
+    bool same = true;
+    for (size_t size : {size_t(1), size_t(63), size_t(64), size_t(65), size_t(200)}) {
+        for (double density : {0.0, 0.1, 0.5, 0.9, 1.0}) {
+            OccupancyBitmap bitmap(size);
+            std::vector<char> bits(size, 0);
+            std::bernoulli_distribution set(density);
+            for (size_t i = 0; i < size; ++i) {
+                if (set(rng)) {
+                    bitmap.Set(i);
+                    bits[i] = 1;
+                }
+            }
+            size_t count = 0;
+            for (char b : bits) count += b;
+            same = same && bitmap.CountSet() == count;
+            std::vector<size_t> visited;
+            bitmap.ForEachSet([&](size_t i) { visited.push_back(i); });
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < size; ++i) {
+                if (bits[i]) expected.push_back(i);
+            }
+            same = same && visited == expected;
+            for (size_t i = 0; i < size; ++i) {
+                size_t next_set = i, next_free = i, prev_free = i + 1;
+                while (next_set < size && !bits[next_set]) next_set++;
+                while (next_free < size && bits[next_free]) next_free++;
+                while (prev_free > 0 && bits[prev_free - 1]) prev_free--;
+                prev_free = prev_free > 0 ? prev_free - 1 : size;
+                size_t nearest = prev_free == size ? next_free
+                               : next_free == size ? prev_free
+                               : (next_free - i < i - prev_free ? next_free : prev_free);
+                same = same && bitmap.Test(i) == (bits[i] != 0) && bitmap.NextSet(i) == next_set &&
+                       bitmap.NextFree(i) == next_free && bitmap.PrevFree(i) == prev_free &&
+                       bitmap.NearestFree(i) == nearest;
+            }
+        }
+    }
+    Check(same, "occupancy bitmap queries match a plain scan");
+}
+
+// A predator whose only target is a patch held by prey stays where it is,
+// and after many steps every patch holds at most one organism and the
+// occupancy bitmap marks exactly the occupied patches.
+static void TestOccupiedTargetsBlockMoves() {
+    World line(3);
+    line.SetPredatorDeathRate(0.0);
+    line.AddOrganism(Species::Prey2, 0.5, 0.0, 0.0, 2);
+    line.AddOrganism(Species::Predator, 0.5, 0.8, 1.0, 0);
+    for (int generation = 0; generation < 20; ++generation) line.Step();
+    const OrganismStore& few = line.GetOrganisms();
+    size_t predator = few.SpeciesBegin(Species::Predator);
+    Check(few.Size() == 2 && few.GetPatch(predator) == 0, "a predator aiming at an occupied patch stays put");
+
+    World world(30 * 30);
+    world.SetOffspringPlacement(OffspringPlacement::NearestFreePatch);
+    world.ResetOrganisms(200, 200, 10, 10, 10);
+    bool one_each = true;
+    for (int generation = 0; generation < 20; ++generation) {
+        world.Step();
+        const OrganismStore& organisms = world.GetOrganisms();
+        std::vector<int> occupants(world.GetPatchCount(), 0);
+        for (size_t d = 0; d < organisms.Size(); ++d) occupants[organisms.GetPatch(d)]++;
+        for (size_t j = 0; j < occupants.size(); ++j) {
+            one_each = one_each && occupants[j] <= 1 && world.IsOccupied(j) == (occupants[j] == 1);
+        }
+    }
+    Check(one_each, "every patch holds at most one organism and the bitmap tracks them");
+}
+
+// Every patch order numbers the patches 0 .. n - 1 once each, and patch
+// -> coordinates -> patch and patch -> row-major -> patch give back the
+// same patch, on square, power-of-two and ragged grids. On a power-of-two
+// square, consecutive Hilbert patches are grid neighbors.
+static void TestPatchOrdersRoundTrip() {
+    bool round_trip = true;
+    for (auto [width, height] : {std::pair<size_t, size_t>{8, 8}, {13, 7}, {1, 9}, {10, 1}, {33, 17}}) {
+        for (PatchOrder order : {PatchOrder::RowMajor, PatchOrder::Morton, PatchOrder::Hilbert}) {
+            GridTopology grid(width, height, order);
+            std::vector<int> seen(width * height, 0);
+            for (size_t r = 0; r < seen.size(); ++r) {
+                size_t i = grid.FromRowMajor(r);
+                if (i >= seen.size()) {
+                    round_trip = false;
+                    continue;
+                }
+                seen[i]++;
+                round_trip = round_trip && grid.RowMajorIndex(i) == r && grid.X(i) == r % width &&
+                             grid.Y(i) == r / width && grid.Index(grid.X(i), grid.Y(i)) == i;
+            }
+            for (int count : seen) round_trip = round_trip && count == 1;
+        }
+    }
+    Check(round_trip, "patch orders convert to coordinates and back");
+
+    GridTopology hilbert(8, 8, PatchOrder::Hilbert);
+    bool contiguous = true;
+    for (size_t i = 1; i < 64; ++i) {
+        size_t step = (hilbert.X(i) > hilbert.X(i - 1) ? hilbert.X(i) - hilbert.X(i - 1) : hilbert.X(i - 1) - hilbert.X(i)) +
+                      (hilbert.Y(i) > hilbert.Y(i - 1) ? hilbert.Y(i) - hilbert.Y(i - 1) : hilbert.Y(i - 1) - hilbert.Y(i));
+        contiguous = contiguous && step == 1;
+    }
+    Check(contiguous, "the Hilbert order moves one patch at a time");
+}
+
+// Runs 15 generations of a 24x18 world stored in the given order, with
+// local movement, adjacent offspring, predation and the environment,
+// after setting it up in row-major order.
+static World RunInOrder(PatchOrder order, size_t threads) {
+    World world(24, 18);
+    world.SetSeed(47);
+    world.SetThreadCount(threads);
+    world.SetNeighborhood(Neighborhood::Moore, 2, GridEdges::Torus);
+    world.SetOffspringPlacement(OffspringPlacement::AdjacentPatch);
+    world.EnablePredation();
+    world.EnableEnvironment();
+    world.ResetOrganisms(60, 60, 8, 8, 8);
+    world.SetPatchOrder(order);
+    for (int generation = 0; generation < 15; ++generation) world.Step();
+    return world;
+}
+
+// True if both worlds hold the same organisms in the same dense order on
+// the same grid coordinates, and the same resource and danger at every
+// coordinate, whatever order each stores its patches in.
+static bool SameStateByCoordinates(const World& a, const World& b) {
+    const OrganismStore& x = a.GetOrganisms();
+    const OrganismStore& y = b.GetOrganisms();
+    if (a.GetGeneration() != b.GetGeneration() || x.Size() != y.Size()) return false;
+    for (size_t d = 0; d < x.Size(); ++d) {
+        if (x.GetSpecies(d) != y.GetSpecies(d) || a.PatchX(x.GetPatch(d)) != b.PatchX(y.GetPatch(d)) ||
+            a.PatchY(x.GetPatch(d)) != b.PatchY(y.GetPatch(d)) || x.GetAlpha(d) != y.GetAlpha(d) ||
+            x.GetTau(d) != y.GetTau(d) || x.GetMoveRate(d) != y.GetMoveRate(d) ||
+            x.GetBirthZone(d) != y.GetBirthZone(d)) {
+            return false;
+        }
+    }
+    for (size_t py = 0; py < a.GetHeight(); ++py) {
+        for (size_t px = 0; px < a.GetWidth(); ++px) {
+            size_t i = a.PatchIndex(px, py), j = b.PatchIndex(px, py);
+            if (a.GetResourceLevel(i) != b.GetResourceLevel(j) || a.GetDangerLevel(i) != b.GetDangerLevel(j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// With neighborhood movement and adjacent offspring, which visit patches
+// by grid offset, a world stored in Morton or Hilbert order follows the
+// same trajectory as one stored row by row, sequentially and with threads.
+static void TestCurveOrdersMatchRowMajor() {
+    for (size_t threads : {size_t(0), size_t(3)}) {
+        World row_major = RunInOrder(PatchOrder::RowMajor, threads);
+        std::string mode = threads ? "parallel" : "sequential";
+        Check(row_major.GetOrganisms().Size() > 0, "the " + mode + " patch order run keeps organisms alive");
+        Check(SameStateByCoordinates(RunInOrder(PatchOrder::Morton, threads), row_major),
+              "a " + mode + " Morton run matches the row-major run");
+        Check(SameStateByCoordinates(RunInOrder(PatchOrder::Hilbert, threads), row_major),
+              "a " + mode + " Hilbert run matches the row-major run");
+    }
+}
+
+// AdjacentPatch offspring land beside their parent on the grid, never at
+// the other end of a row, whatever the patch order.
+static void TestAdjacentOffspringStayInRow() {
+    for (PatchOrder order : {PatchOrder::RowMajor, PatchOrder::Morton, PatchOrder::Hilbert}) {
+        World world(6, 5);
+        world.SetSeed(3);
+        world.SetPatchOrder(order);
+        world.SetOffspringPlacement(OffspringPlacement::AdjacentPatch);
+        for (size_t y = 0; y < world.GetHeight(); y += 2) {
+            // Parents at both ends of every other row, so the patches
+            // between them and the rows on either side are free.
+            world.AddOrganism(Species::Prey2, 0.5, 0.0, 0.0, world.PatchIndex(0, y));
+            world.AddOrganism(Species::Prey2, 0.5, 0.0, 0.0, world.PatchIndex(world.GetWidth() - 1, y));
+        }
+        size_t parents = world.GetOrganisms().Size();
+        world.Reproduce();
+
+        const OrganismStore& organisms = world.GetOrganisms();
+        bool beside = organisms.Size() > parents;
+        for (size_t d = 0; d < organisms.Size(); ++d) {
+            size_t x = world.PatchX(organisms.GetPatch(d));
+            size_t y = world.PatchY(organisms.GetPatch(d));
+            beside = beside && y % 2 == 0 && (x <= 1 || x + 2 >= world.GetWidth());
+        }
+        Check(beside, "AdjacentPatch offspring are placed beside their parents");
+    }
+}
+
+// Neighborhoods visit every patch at most once, including tori with a
+// side too short to wrap: a 1-row world, a 2-row world and a 1-column
+// world, at radii up to beyond the long side.
+static void TestNeighborhoodsVisitEachPatchOnce() {
+    bool once = true;
+    for (auto [width, height] : {std::pair<size_t, size_t>{7, 1}, {1, 7}, {6, 2}, {5, 5}}) {
+        for (Neighborhood kind : {Neighborhood::Moore, Neighborhood::VonNeumann}) {
+            for (int radius : {1, 2, 3, 9}) {
+                GridTopology grid(width, height);
+                grid.SetNeighborhood(kind, radius, GridEdges::Torus);
+                for (size_t i = 0; i < width * height; ++i) {
+                    std::vector<int> visits(width * height, 0);
+                    grid.ForEachNeighbor(i, [&](size_t j) { visits[j]++; });
+                    for (int v : visits) once = once && v <= 1;
+                    once = once && visits[i] == 1;
+                }
+            }
+        }
+    }
+    GridTopology line(7, 1);
+    line.SetNeighborhood(Neighborhood::Moore, 1, GridEdges::Torus);
+    std::vector<size_t> around;
+    line.ForEachNeighbor(0, [&](size_t j) { around.push_back(j); });
+    Check(once, "torus neighborhoods visit each patch once");
+    Check(around == std::vector<size_t>({6, 0, 1}), "a 1-row torus wraps along its row only");
+}
+
+// Capped binomial litters and geometric skips have the distribution of
+// the Bernoulli loops they replace: mean, variance and every P(k) agree
+// with the exact values, as do those of the loops themselves.
+static void TestSkipSamplingDistributions() {
+    const int samples = 200000;
+    CounterRandom rng(41, 0, 0, 0);
+    bool binomial_ok = true;
+    for (auto [n, p, cap] : {std::tuple<int, double, size_t>{4, 0.3, 4}, {7, 0.05, 7}, {10, 0.6, 10},
+                             {10, 0.5, 3}, {1, 0.9, 1}}) {
+        std::vector<double> exact(cap + 1, 0.0);
+        for (int k = 0; k <= n; ++k) {
+            double pmf = std::tgamma(n + 1.0) / (std::tgamma(k + 1.0) * std::tgamma(n - k + 1.0)) *
+                         std::pow(p, k) * std::pow(1.0 - p, n - k);
+            exact[std::min(static_cast<size_t>(k), cap)] += pmf;
+        }
+        double mean = 0.0, second = 0.0;
+        for (size_t k = 0; k <= cap; ++k) {
+            mean += k * exact[k];
+            second += k * k * exact[k];
+        }
+        double variance = second - mean * mean;
+        for (bool skip : {true, false}) {
+            std::vector<double> seen(cap + 1, 0.0);
+            double sum = 0.0, sum_sq = 0.0;
+            for (int i = 0; i < samples; ++i) {
+                size_t k = 0;
+                if (skip) {
+                    k = CappedBinomial(rng, n, p, cap);
+                } else {
+                    for (int b = 0; b < n && k < cap; ++b) k += rng.P(p);
+                }
+                seen[k] += 1.0 / samples;
+                sum += static_cast<double>(k);
+                sum_sq += static_cast<double>(k * k);
+            }
+            double sample_mean = sum / samples;
+            double sample_variance = sum_sq / samples - sample_mean * sample_mean;
+            binomial_ok = binomial_ok && Near(sample_mean, mean, std::sqrt(variance / samples)) &&
+                          Near(sample_variance, variance, variance * std::sqrt(2.0 / samples) + 1e-3);
+            for (size_t k = 0; k <= cap; ++k) {
+                binomial_ok = binomial_ok && Near(seen[k], exact[k], std::sqrt(exact[k] * (1 - exact[k]) / samples));
+            }
+        }
+    }
+    Check(binomial_ok, "capped binomial litters match the Bernoulli loop");
+
+    bool geometric_ok = true;
+    for (double p : {0.02, 0.2, 0.7}) {
+        double mean = (1 - p) / p;
+        double variance = (1 - p) / (p * p);
+        std::vector<double> seen(5, 0.0);
+        double sum = 0.0, sum_sq = 0.0;
+        for (int i = 0; i < samples; ++i) {
+            double k = static_cast<double>(GeometricSkip(rng, p));
+            if (k < seen.size()) seen[static_cast<size_t>(k)] += 1.0 / samples;
+            sum += k;
+            sum_sq += k * k;
+        }
+        double sample_mean = sum / samples;
+        double sample_variance = sum_sq / samples - sample_mean * sample_mean;
+        // The variance of a geometric sample variance involves the fourth
+        // moment; 10% is over five standard errors at these sizes.
+        geometric_ok = geometric_ok && Near(sample_mean, mean, std::sqrt(variance / samples)) &&
+                       std::abs(sample_variance / variance - 1.0) < 0.1;
+        for (size_t k = 0; k < seen.size(); ++k) {
+            double exact = std::pow(1 - p, static_cast<double>(k)) * p;
+            geometric_ok = geometric_ok && Near(seen[k], exact, std::sqrt(exact * (1 - exact) / samples));
+        }
+
+        // Success rate and runs of BernoulliTrials with skipping.
+        BernoulliTrials trials(p, true);
+        double successes = 0.0;
+        for (int i = 0; i < samples; ++i) successes += trials.Next(rng);
+        geometric_ok = geometric_ok && Near(successes / samples, p, std::sqrt(p * (1 - p) / samples));
+    }
+    Check(geometric_ok, "geometric skips match runs of Bernoulli trials");
+}
+
+// Deaths among 1000 predators in one cull, over many seeds: culling with
+// skips and culling organism by organism give the same binomial mean and
+// variance, sequentially and with threads.
+static void TestSkipCullingMatchesPerOrganism() {
+    const int replicates = 400;
+    const size_t predators = 1000;
+    const double rate = 0.05;
+    double mean = predators * rate;
+    double variance = predators * rate * (1 - rate);
+    bool same = true;
+    for (size_t threads : {size_t(0), size_t(2)}) {
+        for (bool skip : {true, false}) {
+            double sum = 0.0, sum_sq = 0.0;
+            for (int r = 0; r < replicates; ++r) {
+                World world(1000);
+                world.SetSeed(1000 + r);
+                world.SetThreadCount(threads);
+                world.SetSkipSampling(skip);
+                world.SetPredatorDeathRate(rate);
+                for (size_t j = 0; j < predators; ++j) world.AddOrganism(Species::Predator, 0.5, 0.8, 0.0, j);
+                world.CullDead();
+                double deaths = static_cast<double>(predators - world.GetPredatorCount());
+                sum += deaths;
+                sum_sq += deaths * deaths;
+            }
+            double sample_mean = sum / replicates;
+            double sample_variance = sum_sq / replicates - sample_mean * sample_mean;
+            same = same && Near(sample_mean, mean, std::sqrt(variance / replicates)) &&
+                   Near(sample_variance, variance, variance * std::sqrt(2.0 / replicates));
+        }
+    }
+    Check(same, "culling with skips matches culling organism by organism");
+}
+
+// Runs 30 generations of a 40x40 world with the given threads and tile
+// size (0 for untiled).
+static World RunThreaded(size_t threads, size_t tile, Neighborhood neighborhood) {
+    World world(40, 40);
+    world.SetSeed(21);
+    world.SetThreadCount(threads);
+    world.SetTileSize(tile, tile);
+    world.SetNeighborhood(neighborhood, 2);
+    world.SetOffspringPlacement(OffspringPlacement::NearestFreePatch);
+    world.ResetOrganisms(300, 300, 15, 15, 15);
+    for (int generation = 0; generation < 30; ++generation) world.Step();
+    return world;
+}
+
+// Parallel steps give the same organisms in the same dense order for any
+// thread count, with or without tiles.
+static void TestThreadCountDoesNotChangeResults() {
+    for (Neighborhood neighborhood : {Neighborhood::Global, Neighborhood::Moore}) {
+        World reference = RunThreaded(1, 0, neighborhood);
+        Check(reference.GetTotalOrganismCount() > 0, "the threaded reference run keeps organisms");
+        for (size_t threads : {size_t(1), size_t(2), size_t(7)}) {
+            for (size_t tile : {size_t(0), size_t(8)}) {
+                Check(SameState(RunThreaded(threads, tile, neighborhood), reference),
+                      std::to_string(threads) + " threads with tile size " + std::to_string(tile) +
+                      " match one untiled thread");
+            }
+        }
+    }
+}
+
+// A predator with prey beside it, on a 3x1 world where nothing moves or
+// dies. With certain capture and conversion it eats the prey and has one
+// offspring in a patch beside it. Returns the predator count after a step.
+static int PredatorsAfterCatch(size_t threads) {
+    World world(3, 1);
+    world.SetSeed(5);
+    world.SetPredatorDeathRate(0.0);
+    world.SetThreadCount(threads);
+    world.SetOffspringPlacement(OffspringPlacement::AdjacentPatch);
+    PredationParams params;
+    params.capture_probability = 1.0;
+    params.conversion = 1.0;
+    world.EnablePredation(params);
+    world.AddOrganism(Species::Prey2, 0.5, 0.0, 0.0, world.PatchIndex(0, 0));
+    world.AddOrganism(Species::Predator, 0.5, 0.8, 0.0, world.PatchIndex(1, 0));
+    world.Step();
+    bool caught = world.GetLastCaptureCount() == 1 && world.GetPrey2Count() == 0;
+    return caught ? world.GetPredatorCount() : -1;
+}
+
+static void TestPredatorBreedsFromCatch() {
+    Check(PredatorsAfterCatch(0) == 2, "a predator that caught prey gives birth in the sequential step");
+    Check(PredatorsAfterCatch(2) == 2, "a predator that caught prey gives birth in the parallel step");
+}
+
+// True if the world's census holds what a full recount of the organism
+// store gives: per-patch prey and predator counts, per-group counts in
+// every zone, and per-group trait sums.
+static bool CensusMatchesRecount(const World& world) {
+    const OrganismStore& organisms = world.GetOrganisms();
+    std::vector<int> prey(world.GetPatchCount(), 0), predators(world.GetPatchCount(), 0);
+    int counts[3][3] = {};
+    double alpha_sums[3] = {}, tau_sums[3] = {};
+    for (size_t d = 0; d < organisms.Size(); ++d) {
+        size_t j = organisms.GetPatch(d);
+        bool is_prey = organisms.IsPrey(d);
+        (is_prey ? prey : predators)[j]++;
+        int g = static_cast<int>(PopulationCensus::GroupOf(is_prey, organisms.GetTau(d)));
+        counts[g][world.GetZone(j)]++;
+        alpha_sums[g] += organisms.GetAlpha(d);
+        tau_sums[g] += organisms.GetTau(d);
+    }
+    for (size_t j = 0; j < world.GetPatchCount(); ++j) {
+        if (world.GetPatchPreyCount(j) != prey[j] || world.GetPatchPredatorCount(j) != predators[j]) return false;
+    }
+    const PopulationCensus& census = world.GetCensus();
+    for (CensusGroup group : {CensusGroup::Prey1, CensusGroup::Prey2, CensusGroup::Predator}) {
+        int g = static_cast<int>(group);
+        for (int zone = 0; zone < 3; ++zone) {
+            if (census.Count(group, zone) != counts[g][zone]) return false;
+        }
+        if (std::abs(census.AlphaSum(group) - alpha_sums[g]) > 1e-6 ||
+            std::abs(census.TauSum(group) - tau_sums[g]) > 1e-6) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The census kept up to date step by step matches a full recount after
+// every generation of moves, captures, births (with mutation carrying prey
+// across the tau split), culls and resource changes that move occupied
+// patches between zones, sequentially and with threads.
+static void TestCensusMatchesRecount() {
+    for (size_t threads : {size_t(0), size_t(3)}) {
+        World world(30 * 30);
+        world.SetSeed(43);
+        world.SetThreadCount(threads);
+        world.SetOffspringPlacement(OffspringPlacement::NearestFreePatch);
+        world.SetMutationRate(0.3);
+        world.SetMutationSD(0.1);
+        world.EnablePredation();
+        std::mt19937 setup(43);
+        std::uniform_real_distribution<double> level(0.0, 1.0);
+        for (size_t j = 0; j < world.GetPatchCount(); ++j) world.SetResourceLevel(j, level(setup));
+        world.ResetOrganisms(150, 150, 20, 20, 20);
+        bool same = CensusMatchesRecount(world);
+        std::uniform_int_distribution<size_t> pick(0, world.GetPatchCount() - 1);
+        size_t captures = 0;
+        for (int generation = 0; generation < 25; ++generation) {
+            world.Step();
+            captures += world.GetLastCaptureCount();
+            for (int change = 0; change < 50; ++change) world.SetResourceLevel(pick(setup), level(setup));
+            same = same && CensusMatchesRecount(world);
+        }
+        std::string mode = threads ? "parallel" : "sequential";
+        Check(captures > 0, "the " + mode + " census run sees captures");
+        Check(same, "the census matches a full recount after every " + mode + " step");
+    }
+}
+
+// Keeps every row it is given, to check what a DataCollector wrote.
+class RecordingSink : public DataSink {
+public:
+    int begins = 0;
+    size_t columns = 0;
+    std::vector<uint64_t> generations;
+    std::vector<std::vector<double>> rows;
+
+    void Begin(const std::vector<DataColumn>& cols) override {
+        begins++;
+        columns = cols.size();
+    }
+
+    void Write(uint64_t generation, const std::vector<double>& values) override {
+        generations.push_back(generation);
+        rows.push_back(values);
+    }
+};
+
+// Observers registered with different intervals each write on exactly the
+// generations that are multiples of their interval (0 counts as 1), with
+// the state of the world at that generation, and their sinks see one
+// Begin with the observer's columns.
+static void TestObserversFireOnTheirIntervals() {
+    World world(20 * 20);
+    world.SetSeed(59);
+    world.SetOffspringPlacement(OffspringPlacement::NearestFreePatch);
+    std::mt19937 setup(59);
+    std::uniform_real_distribution<double> level(0.0, 1.0);
+    for (size_t j = 0; j < world.GetPatchCount(); ++j) world.SetResourceLevel(j, level(setup));
+    world.ResetOrganisms(80, 80, 10, 10, 10);
+
+    DataCollector collector;
+    std::vector<uint64_t> intervals = {1, 3, 7, 0};
+    std::vector<std::shared_ptr<RecordingSink>> sinks;
+    for (uint64_t interval : intervals) {
+        sinks.push_back(std::make_shared<RecordingSink>());
+        collector.Add(std::make_unique<PopulationStatsObserver>(), sinks.back(), interval);
+    }
+
+    std::vector<std::vector<double>> expected_rows;
+    for (uint64_t generation = 0; generation <= 22; ++generation) {
+        if (generation > 0) world.Step();
+        collector.Collect(world, world.GetGeneration());
+        std::vector<double> row;
+        PopulationStatsObserver().Sample(world, row);
+        expected_rows.push_back(row);
+    }
+
+    for (size_t k = 0; k < intervals.size(); ++k) {
+        uint64_t interval = std::max<uint64_t>(1, intervals[k]);
+        std::vector<uint64_t> expected_generations;
+        std::vector<std::vector<double>> rows;
+        for (uint64_t generation = 0; generation <= 22; generation += interval) {
+            expected_generations.push_back(generation);
+            rows.push_back(expected_rows[generation]);
+        }
+        const RecordingSink& sink = *sinks[k];
+        Check(sink.begins == 1 && sink.columns == PopulationStatsObserver().Columns().size() &&
+              sink.generations == expected_generations && sink.rows == rows,
+              "an observer with interval " + std::to_string(intervals[k]) + " writes on its generations");
+    }
+}
+
+// Output rings are sized by bytes, so a sink with one column per patch
+// stays within its budget however large the world, while narrow stats rows
+// still get the full row count.
+static void TestAsyncRingFitsBudget() {
+    size_t budget = AsyncSink::default_ring_bytes;
+    for (size_t width : {size_t(14), size_t(3600), size_t(1000000)}) {
+        size_t rows = AsyncSink::RingRows(width, budget);
+        size_t bytes = rows * (width + 1) * sizeof(double);
+        Check(rows >= 2 && (rows == 2 || bytes <= budget),
+              "a " + std::to_string(width) + "-column ring fits its byte budget");
+    }
+    Check(AsyncSink::RingRows(14, budget) == 4096, "a stats ring keeps 4096 rows");
+}
+
+// Returns the whole file at path as a string.
+static std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Rows written to a .ppcol file and exported to CSV give the same file,
+// byte for byte, as the same rows written by CsvSink directly: float and
+// count columns, several blocks and a partial last one, and values that
+// need every digit the CSV prints.
+static void TestColumnarExportMatchesCsv() {
+    const std::string columnar_path = "tests_stats.ppcol";
+    const std::string direct_path = "tests_direct.csv";
+    const std::string exported_path = "tests_exported.csv";
+    std::vector<DataColumn> columns = {{"Prey", true}, {"MeanAlpha", false}, {"Predators", true}, {"Resource", false}};
+    {
+        BinaryColumnSink columnar(columnar_path, 4);
+        CsvSink direct(direct_path);
+        columnar.Begin(columns);
+        direct.Begin(columns);
+        std::mt19937 rng(53);
+        std::uniform_real_distribution<double> value(-2.0, 2.0);
+        std::uniform_int_distribution<int> count(0, 2000000);
+        for (uint64_t generation = 0; generation < 11; ++generation) {
+            std::vector<double> row = {double(count(rng)), value(rng), double(count(rng)), value(rng) * 1e-7};
+            if (generation == 5) row = {0.0, 1.0 / 3.0, 2147483647.0, 1e300};
+            columnar.Write(generation * 10, row);
+            direct.Write(generation * 10, row);
+        }
+    }
+    {
+        BinaryColumnReader reader(columnar_path);
+        CsvSink exported(exported_path);
+        Check(reader.IsValid(), "a written .ppcol file reads back");
+        ExportColumns(reader, exported);
+    }
+    std::string direct = ReadFile(direct_path);
+    Check(!direct.empty() && ReadFile(exported_path) == direct, "a .ppcol file exports to the CSV written directly");
+    for (const std::string& path : {columnar_path, direct_path, exported_path}) std::remove(path.c_str());
+}
+
+// A checkpoint whose header claims more organisms than the file could
+// hold, with counts chosen so the section offsets wrap around, is rejected
+// instead of being read out of bounds. An intact one still loads.
+static void TestCheckpointRejectsOverflowingCounts() {
+    const std::string path = "tests_checkpoint.ckpt";
+    World world(100);
+    world.SetSeed(11);
+    world.ResetOrganisms(20, 20, 0, 0, 5);
+    Check(world.SaveCheckpoint(path), "checkpoint is saved");
+    {
+        CheckpointFile file(path);
+        Check(file.IsValid(), "saved checkpoint is valid");
+        World restored(100);
+        Check(restored.LoadCheckpoint(file), "saved checkpoint loads");
+        Check(restored.GetTotalOrganismCount() == world.GetTotalOrganismCount(), "checkpoint restores every organism");
+    }
+
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    for (uint64_t organisms : {uint64_t(1) << 63, uint64_t(101)}) {
+        CheckpointHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        header.organism_count = organisms;
+        std::vector<char> crafted = bytes;
+        std::memcpy(crafted.data(), &header, sizeof(header));
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(crafted.data(), static_cast<std::streamsize>(crafted.size()));
+        }
+        CheckpointFile file(path);
+        Check(!file.IsValid(), "checkpoint with organism_count " + std::to_string(organisms) + " is rejected");
+    }
+    std::remove(path.c_str());
+}
+
+// A world saved mid-run and restored into a fresh world continues exactly
+// like the original, and the original continues exactly like a twin that
+// was never saved, with emp::Random, BatchRandom and threads. Truncated
+// files, files for a different patch count and files of another format
+// version are rejected.
+static bool RestoredRunMatches(size_t threads, bool batched) {
+    const std::string path = "tests_resume.ckpt";
+    World world(900), twin(900);
+    for (World* w : {&world, &twin}) {
+        w->SetSeed(19);
+        w->SetThreadCount(threads);
+        w->SetBatchedRandom(batched);
+        w->SetOffspringPlacement(OffspringPlacement::AdjacentPatch);
+        w->SetPredatorDeathRate(0.05);
+        w->EnablePredation();
+        w->ResetOrganisms(100, 100, 10, 10, 10);
+        for (int generation = 0; generation < 3; ++generation) w->Step();
+    }
+    bool saved = world.SaveCheckpoint(path);
+    World restored(900);
+    restored.SetThreadCount(threads);
+    bool loaded = restored.LoadCheckpoint(path);
+    for (int generation = 0; generation < 10; ++generation) {
+        world.Step();
+        twin.Step();
+        restored.Step();
+    }
+    std::remove(path.c_str());
+    return saved && loaded && SameState(world, restored) && SameState(world, twin);
+}
+
+static void TestCheckpointResumes() {
+    Check(RestoredRunMatches(0, false), "a saved and a restored sequential run continue like the original");
+    Check(RestoredRunMatches(0, true), "a saved and a restored batched run continue like the original");
+    Check(RestoredRunMatches(3, false), "a saved and a restored threaded run continue like the original");
+
+    const std::string path = "tests_truncated.ckpt";
+    World world(100);
+    world.SetSeed(23);
+    world.ResetOrganisms(20, 20, 0, 0, 5);
+    Check(world.SaveCheckpoint(path), "checkpoint is saved");
+    World other_size(120);
+    Check(!other_size.LoadCheckpoint(path), "checkpoint for another patch count is rejected");
+    Check(other_size.GetTotalOrganismCount() == 0, "a rejected checkpoint leaves the world as it was");
+
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    for (size_t keep : {bytes.size() - 1, sizeof(CheckpointHeader), size_t(10)}) {
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(keep));
+        }
+        World restored(100);
+        Check(!restored.LoadCheckpoint(path), "checkpoint cut to " + std::to_string(keep) + " bytes is rejected");
+    }
+    for (uint32_t version : {CheckpointHeader::current_version - 1, CheckpointHeader::current_version + 1}) {
+        std::vector<char> other_version = bytes;
+        std::memcpy(other_version.data() + offsetof(CheckpointHeader, version), &version, sizeof(version));
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(other_version.data(), static_cast<std::streamsize>(other_version.size()));
+        }
+        CheckpointFile file(path);
+        World restored(100);
+        Check(!file.IsValid() && file.Version() == version && !restored.LoadCheckpoint(file),
+              "a version " + std::to_string(version) + " checkpoint is reported as unsupported");
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "Generation,Prey\n0,10\n";
+    }
+    CheckpointFile not_checkpoint(path);
+    Check(!not_checkpoint.IsValid() && not_checkpoint.Version() == 0, "a file that is not a checkpoint has no version");
+    std::remove(path.c_str());
+}
+
+// A world saved with the environment on and restored into a fresh world
+// continues exactly like the original: capacities, danger and the
+// environment's rates come from the file.
+static void TestCheckpointKeepsEnvironment() {
+    const std::string path = "tests_environment.ckpt";
+    World world(20, 20);
+    world.SetSeed(13);
+    world.SetOffspringPlacement(OffspringPlacement::NearestFreePatch);
+    EnvironmentParams params;
+    params.regrowth = 0.2f;
+    world.EnableEnvironment(params);
+    world.ResetOrganisms(60, 60, 5, 5, 5);
+    for (int generation = 0; generation < 5; ++generation) world.Step();
+    Check(world.SaveCheckpoint(path), "checkpoint with the environment is saved");
+
+    World restored(20, 20);
+    Check(restored.LoadCheckpoint(path), "checkpoint with the environment loads");
+    Check(restored.IsEnvironmentEnabled() && restored.GetEnvironment().regrowth == 0.2f,
+          "checkpoint restores the environment settings");
+    for (int generation = 0; generation < 10; ++generation) {
+        world.Step();
+        restored.Step();
+    }
+    Check(SameState(world, restored), "a world restored with the environment continues like the original");
+    std::remove(path.c_str());
+}
+
+// Predation settings and catches not yet bred from survive a checkpoint:
+// a predator that caught prey just before the save still gives birth in a
+// restored world, and a restored predation run continues like the original.
+static void TestCheckpointKeepsPredation() {
+    const std::string path = "tests_predation.ckpt";
+    World world(3, 1);
+    world.SetSeed(5);
+    world.SetPredatorDeathRate(0.0);
+    world.SetOffspringPlacement(OffspringPlacement::AdjacentPatch);
+    PredationParams params;
+    params.capture_probability = 1.0;
+    params.conversion = 1.0;
+    world.EnablePredation(params);
+    world.AddOrganism(Species::Prey2, 0.5, 0.0, 0.0, world.PatchIndex(0, 0));
+    world.AddOrganism(Species::Predator, 0.5, 0.8, 0.0, world.PatchIndex(1, 0));
+    world.Predation();
+    Check(world.SaveCheckpoint(path), "checkpoint with pending catches is saved");
+    World restored(3, 1);
+    Check(restored.LoadCheckpoint(path), "checkpoint with pending catches loads");
+    Check(restored.IsPredationEnabled() && restored.GetPredation().capture_probability == 1.0,
+          "checkpoint restores the predation settings");
+    restored.Reproduce();
+    Check(restored.GetPredatorCount() == 2, "a restored predator breeds from a catch made before the save");
+
+    World big(30, 30);
+    big.SetSeed(17);
+    big.SetOffspringPlacement(OffspringPlacement::AdjacentPatch);
+    big.EnablePredation(params);
+    big.ResetOrganisms(150, 150, 10, 10, 10);
+    for (int generation = 0; generation < 5; ++generation) big.Step();
+    Check(big.SaveCheckpoint(path), "checkpoint with predation is saved");
+    World big_restored(30, 30);
+    Check(big_restored.LoadCheckpoint(path), "checkpoint with predation loads");
+    for (int generation = 0; generation < 10; ++generation) {
+        big.Step();
+        big_restored.Step();
+    }
+    Check(SameState(big, big_restored), "a world restored with predation continues like the original");
+    std::remove(path.c_str());
+}
+
+int main() {
+    TestPredatorTablesMatchRoulette();
+    TestResourceIndexMatchesFreshBuild();
+    TestIndexedPreyMovesMatchRoulette();
+    TestPatchScoreKernelMatchesScalar();
+    TestPatchOrdersRoundTrip();
+    TestCurveOrdersMatchRowMajor();
+    TestAdjacentOffspringStayInRow();
+    TestNeighborhoodsVisitEachPatchOnce();
+    TestSkipSamplingDistributions();
+    TestSkipCullingMatchesPerOrganism();
+    TestPrey2StoredImmobile();
+    TestOccupancyBitmapMatchesScan();
+    TestOccupiedTargetsBlockMoves();
+    TestThreadCountDoesNotChangeResults();
+    TestPredatorBreedsFromCatch();
+    TestCensusMatchesRecount();
+    TestObserversFireOnTheirIntervals();
+    TestAsyncRingFitsBudget();
+    TestColumnarExportMatchesCsv();
+    TestCheckpointRejectsOverflowingCounts();
+    TestCheckpointResumes();
+    TestCheckpointKeepsEnvironment();
+    TestCheckpointKeepsPredation();
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
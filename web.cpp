@@ -58,7 +58,7 @@ class WebAnimator : public emp::web::Animate {
 
 public:
     WebAnimator()
-        : world(num_columns * num_rows),
+        : world(num_columns, num_rows),
           canvas(num_columns * cell_width, num_rows * cell_height, "canvas"),
           // Initialize buttons
           step_btn([this]() { Step(); }, "Step"),
@@ -193,11 +193,11 @@ public:
     }
 
     void SetupWorldCloning() {
-        // This ensures new organisms are created as the correct derived types after mutation
-        world.SetCloneFunction([](bool is_prey, double a, double t, double m) -> Organism* {
-            if (!is_prey) return new Predator(a, t, m);
-            if (t > 0.5) return new Prey(a, t, m); // Prey1 (mobile)
-            return new Prey2(a, t, m); // Prey2 (immobile)
+        // This ensures new organisms are created as the correct species after mutation
+        world.SetOffspringSpeciesFunction([](bool is_prey, double, double t, double) {
+            if (!is_prey) return Species::Predator;
+            if (t > 0.5) return Species::Prey; // Prey1 (mobile)
+            return Species::Prey2; // Prey2 (immobile)
         });
     }
 
@@ -207,11 +207,11 @@ public:
         world.SetMutationRate(current_mutation_rate);
         world.SetMutationSD(current_mutation_sd);
 
-        world = World(num_columns * num_rows); // Re-initialize world to clear all organisms and patches
+        world = World(num_columns, num_rows); // Re-initialize world to clear all organisms and patches
         world.SetPredatorDeathRate(current_predator_death_rate); // Re-apply after world creation
         world.SetMutationRate(current_mutation_rate);
         world.SetMutationSD(current_mutation_sd);
-        SetupWorldCloning(); // Re-apply clone function to new world instance
+        SetupWorldCloning(); // Re-apply species function to new world instance
 
         generation = 0;
 
@@ -228,8 +228,7 @@ public:
                 for (int dx = 0; dx < 10; ++dx) {
                     int x = x_start + dx;
                     int y = y_start + dy;
-                    int idx = y * num_columns + x;
-                    world.GetPatchesMutable()[idx].resource_level = r;
+                    world.SetResourceLevel(world.PatchIndex(x, y), r);
                 }
             }
         }
@@ -268,28 +267,27 @@ public:
 
     void Draw() {
         canvas.Clear();
-        const auto& patches = world.GetPatches();
+        const OrganismStore& organisms = world.GetOrganisms();
 
-        for (size_t i = 0; i < patches.size(); ++i) {
-            int x = (i % num_columns) * cell_width;
-            int y = (i / num_columns) * cell_height;
-            const auto& patch = patches[i];
+        for (size_t i = 0; i < world.GetPatchCount(); ++i) {
+            int x = static_cast<int>(world.PatchX(i)) * cell_width;
+            int y = static_cast<int>(world.PatchY(i)) * cell_height;
+            OrganismHandle occupant = world.GetOccupant(i);
 
-            std::string bg = ResourceColor(patch.resource_level);
+            std::string bg = ResourceColor(world.GetResourceLevel(i));
             std::string occupant_fill_color = bg; // Default to background color
 
-            // Determine occupant color based on the *first* organism found
-            // For more complex rendering (e.g., multiple organisms), you'd need overlays
-            for (Organism* org : patch.occupants) {
-                if (!org->IsPrey()) occupant_fill_color = "pink"; // Predator
-                else if (org->GetTau() > 0.5) occupant_fill_color = "blue"; // Prey1 (mobile)
+            // Determine occupant color (each patch holds at most one organism)
+            if (organisms.IsValid(occupant)) {
+                size_t org = organisms.IndexOf(occupant);
+                if (!organisms.IsPrey(org)) occupant_fill_color = "pink"; // Predator
+                else if (organisms.GetTau(org) > 0.5) occupant_fill_color = "blue"; // Prey1 (mobile)
                 else occupant_fill_color = "cyan"; // Prey2 (immobile)
-                break; // Only draw the first occupant's color
             }
 
             canvas.Rect(x, y, cell_width, cell_height, bg, bg); // Draw patch background
             // Draw a smaller inner rectangle for the occupant, if any
-            if (!patch.occupants.empty()) {
+            if (organisms.IsValid(occupant)) {
                 canvas.Rect(x + 2, y + 2, cell_width - 4, cell_height - 4, occupant_fill_color, "black");
             }
         }
@@ -300,17 +298,18 @@ public:
         out.precision(4); // Set precision for double values
 
         out << "<b>Generation:</b> " << generation << "<br>";
-        out << "<b>Total Organisms:</b> " << world.GetTotalOrganismCount() << "<br>";
+        const PopulationCensus& census = world.GetCensus();
+        out << "<b>Total Organisms:</b> " << census.Total() << "<br>";
         out << "<br>";
 
         // Display counts for each type across all zones
-        out << "<b>Prey1 (Mobile):</b> " << world.GetPrey1Count()
-            << " | Avg Alpha: " << std::fixed << world.GetAveragePreyAlpha(true)
-            << " | Avg Tau: " << std::fixed << world.GetAveragePreyTau(true) << "<br>";
-        out << "<b>Prey2 (Immobile):</b> " << world.GetPrey2Count()
-            << " | Avg Alpha: " << std::fixed << world.GetAveragePreyAlpha(false)
-            << " | Avg Tau: " << std::fixed << world.GetAveragePreyTau(false) << "<br>";
-        out << "<b>Predators:</b> " << world.GetPredatorCount() << "<br>";
+        out << "<b>Prey1 (Mobile):</b> " << census.Count(CensusGroup::Prey1)
+            << " | Avg Alpha: " << std::fixed << census.MeanAlpha(CensusGroup::Prey1)
+            << " | Avg Tau: " << std::fixed << census.MeanTau(CensusGroup::Prey1) << "<br>";
+        out << "<b>Prey2 (Immobile):</b> " << census.Count(CensusGroup::Prey2)
+            << " | Avg Alpha: " << std::fixed << census.MeanAlpha(CensusGroup::Prey2)
+            << " | Avg Tau: " << std::fixed << census.MeanTau(CensusGroup::Prey2) << "<br>";
+        out << "<b>Predators:</b> " << census.Count(CensusGroup::Predator) << "<br>";
 
         stats_div.Clear();
         stats_div << out.str();